@@ -0,0 +1,124 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocations.hpp"
+
+// Os operadores globais de alocação são substituídos nesta unidade de
+// tradução, separada das que alocam: assim, o compilador não vê `free` no
+// lugar de `delete` nos pontos de uso (-Wmismatched-new-delete). Todas as
+// formas são substituídas juntas, de forma que toda alocação é contada e toda
+// liberação usa a função correspondente à alocação.
+
+namespace {
+std::atomic<size_t> g_allocations(0);
+std::atomic<size_t> g_allocated_bytes(0);
+
+void* allocate(size_t size) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocate_or_throw(size_t size) {
+    if (void* ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+#ifdef __cpp_aligned_new
+void* allocate_aligned(size_t size, std::align_val_t alignment) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    // aligned_alloc exige um tamanho múltiplo do alinhamento.
+    size_t align = static_cast<size_t>(alignment);
+    size_t rounded = (size + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded == 0 ? align : rounded);
+}
+
+void* allocate_aligned_or_throw(size_t size, std::align_val_t alignment) {
+    if (void* ptr = allocate_aligned(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+#endif
+}; // namespace
+
+size_t bench::allocations() { return g_allocations; }
+
+size_t bench::allocated_bytes() { return g_allocated_bytes; }
+
+void* operator new(size_t size) { return allocate_or_throw(size); }
+
+void* operator new[](size_t size) { return allocate_or_throw(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+#ifdef __cpp_aligned_new
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocate_aligned_or_throw(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocate_aligned_or_throw(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+#endif
@@ -0,0 +1,19 @@
+#ifndef __BENCH_ALLOCATIONS__
+#define __BENCH_ALLOCATIONS__
+
+#include <cstddef>
+
+namespace bench {
+/**
+ * @brief Número de alocações feitas pelo operador `new` (em todas as suas
+ * formas) desde o início do processo.
+ */
+size_t allocations();
+
+/**
+ * @brief Número de bytes pedidos ao operador `new` desde o início do processo.
+ */
+size_t allocated_bytes();
+}; // namespace bench
+
+#endif // __BENCH_ALLOCATIONS__
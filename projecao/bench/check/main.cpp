@@ -0,0 +1,507 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <io.hpp>
+#include <io/parser.hpp>
+#include <linalg.hpp>
+#include <polyhedral.hpp>
+#include <polyhedral/sharded.hpp>
+
+extern char** environ;
+
+using namespace io;
+using namespace linalg;
+using namespace polyhedral;
+
+using scalar_type = double;
+
+/**
+ * @brief Opções de linha de comando.
+ */
+struct options {
+    // Executável do programa principal.
+    std::string program;
+
+    // Arquivos de entrada.
+    std::vector<std::string> files;
+};
+
+/**
+ * @brief Entrada lida de um arquivo: um poliedro e as direções de projeção
+ * com o mesmo número de dimensões.
+ */
+struct input {
+    std::string name;
+    polyhedron<scalar_type> P;
+    std::vector<vecn<scalar_type>> directions;
+};
+
+/**
+ * @brief Contagem das comparações feitas e das que falharam.
+ */
+class report {
+  private:
+    size_t m_checks = 0;
+    size_t m_failures = 0;
+
+  public:
+    /**
+     * @brief Registra uma comparação, exibindo-a se falhou.
+     *
+     * @param ok Resultado da comparação.
+     * @param mode Modo comparado com a referência.
+     * @param file Arquivo de entrada.
+     * @param detail Descrição da falha.
+     */
+    void expect(bool ok, const std::string& mode, const std::string& file,
+                const std::string& detail = "") {
+        m_checks++;
+        if (!ok) {
+            m_failures++;
+            std::cout << "FAIL " << mode << " " << file;
+            auto end = detail.find_last_not_of('\n');
+            if (end != std::string::npos) {
+                std::cout << ": " << detail.substr(0, end + 1);
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    size_t checks() const { return m_checks; }
+    size_t failures() const { return m_failures; }
+};
+
+/**
+ * @brief Lê um arquivo de entrada no formato do programa principal.
+ */
+static input read_input(const std::string& filename) {
+    std::ifstream stream(filename);
+    if (!stream) {
+        throw std::runtime_error("cannot open " + filename);
+    }
+
+    input in;
+    in.name = filename;
+
+    std::vector<parser::linear_inequality<scalar_type>> inequalities;
+    size_t n = 0, lineno = 1;
+    for (std::string line; std::getline(stream, line); lineno++) {
+        if (line.find_first_not_of(' ') == std::string::npos) {
+            break;
+        }
+        parser::linear_inequality<scalar_type> inequality;
+        parser::parser<scalar_type>(filename.c_str(), lineno, line.cbegin(),
+                                    line.cend())
+            .parse_linear_inequality(line.cbegin(), line.cend(), inequality);
+        n = std::max(n, inequality.lhs.max_variable + 1);
+        inequalities.push_back(std::move(inequality));
+    }
+
+    matnxm<scalar_type> A(inequalities.size(), n);
+    vecn<scalar_type> b(inequalities.size());
+    for (size_t i = 0; i < inequalities.size(); i++) {
+        for (const auto& term : inequalities[i].lhs.parts) {
+            A(i, term.variable) += term.coefficient;
+        }
+        b[i] = inequalities[i].rhs;
+    }
+    in.P = polyhedron<scalar_type>(std::move(A), std::move(b));
+
+    for (std::string line; std::getline(stream, line);) {
+        lineno++;
+        if (parser::skip_blank(line.cbegin(), line.cend()) == line.cend()) {
+            break;
+        }
+        std::vector<scalar_type> coords;
+        parser::parser<scalar_type>(filename.c_str(), lineno, line.cbegin(),
+                                    line.cend())
+            .parse_vector(line.cbegin(), line.cend(), coords);
+        if (coords.size() == n) {
+            vecn<scalar_type> c(n);
+            std::copy(coords.begin(), coords.end(), c.begin());
+            in.directions.push_back(std::move(c));
+        }
+    }
+    return in;
+}
+
+/**
+ * @brief Casos que não aparecem nos exemplos e já expuseram erros.
+ */
+static std::vector<input> regressions() {
+    std::vector<input> cases;
+
+    // Projeção em uma direção fora dos eixos, em que o método de dupla
+    // descrição produzia linhas com a · c da ordem de 1e-12, inclinando o
+    // resultado ao longo de c.
+    matnxm<scalar_type> A(7, 3);
+    vecn<scalar_type> b(7);
+    A[0] = {0, -1, 3}, b[0] = 6;
+    A[1] = {2, 1, -2}, b[1] = 1;
+    A[2] = {-2, 1, -1}, b[2] = 3;
+    A[3] = {-3, 3, 0}, b[3] = 0;
+    A[4] = {-3, 2, -1}, b[4] = 7;
+    A[5] = {-1, 3, 0}, b[5] = 4;
+    A[6] = {3, -3, -2}, b[6] = 2;
+    cases.push_back({"regression: tilted double description",
+                     polyhedron<scalar_type>(std::move(A), std::move(b)),
+                     {vecn<scalar_type>{-1, -2, 0}}});
+
+    return cases;
+}
+
+/**
+ * @brief Determina se dois poliedros têm exatamente as mesmas linhas, na
+ * mesma ordem.
+ */
+static bool same_rows(const polyhedron<scalar_type>& P,
+                      const polyhedron<scalar_type>& Q) {
+    const auto& A = P.A();
+    const auto& B = Q.A();
+    if (A.rows() != B.rows() || A.cols() != B.cols()) {
+        return false;
+    }
+    for (size_t i = 0; i < A.rows(); i++) {
+        if (!std::equal(A.row_data(i), A.row_data(i) + A.cols() + 1,
+                        B.row_data(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Descreve o resultado de um teste de equivalência que falhou.
+ */
+static std::string describe(const inclusion_result& result,
+                            const vecn<scalar_type>& c) {
+    std::ostringstream os;
+    os << "direction " << c << ", row " << result.row << " of the "
+       << (result.first ? "reference is violated by the result"
+                        : "result is violated by the reference");
+    return os.str();
+}
+
+/**
+ * @brief Compara, na biblioteca e em precisão total, os motores de projeção e
+ * de teste de vazio com a eliminação de Fourier-Motzkin em memória.
+ *
+ * Os motores que normalizam, reordenam ou removem linhas são comparados com
+ * `equivalent`; a projeção em fluxo deve gerar exatamente as mesmas linhas.
+ */
+static void check_library(const input& in, report& r) {
+    const auto& P = in.P;
+    size_t n = P.dimensions();
+
+    external_options external;
+    external.memory = 4096;
+    sharded_options sharding;
+    sharding.processes = 2;
+
+    bool is_empty = P.empty();
+    r.expect(filtered_empty(P) == is_empty, "filtered_empty", in.name);
+    r.expect(screened_empty(P) == is_empty, "screened_empty", in.name);
+    r.expect(sharded_empty(P, sharding) == is_empty, "sharded_empty",
+             in.name);
+    r.expect(external_polyhedron<scalar_type>(P, external).empty() ==
+                 is_empty,
+             "external empty", in.name);
+
+    for (const auto& c : in.directions) {
+        budget unlimited;
+        polyhedron<scalar_type> fm =
+            P.project(c, unlimited, projection_engine::FOURIER_MOTZKIN);
+
+        auto compare = [&](const std::string& mode,
+                           const polyhedron<scalar_type>& result) {
+            auto equivalence = equivalent(fm, result);
+            r.expect(bool(equivalence), mode, in.name,
+                     describe(equivalence, c));
+        };
+
+        compare("double description",
+                P.project(c, unlimited, projection_engine::DOUBLE_DESCRIPTION));
+        compare("external",
+                external_polyhedron<scalar_type>(P, external)
+                    .project(c, unlimited)
+                    .load());
+        compare("sharded", sharded_project(P, c, sharding, unlimited));
+
+        size_t j = internal_projection::axis(c);
+        if (j != internal_projection::no_axis) {
+            compare("filtered",
+                    filtered_eliminate(P, {j}, unlimited).expand(n));
+        }
+
+        // As linhas em fluxo são reunidas em uma matriz, bloco a bloco.
+        stream_options streaming;
+        streaming.chunk = 3;
+        std::vector<scalar_type> rows;
+        size_t count = stream_project(
+            P, c,
+            [&](const matnxm<scalar_type>& block, size_t k) {
+                for (size_t i = 0; i < k; i++) {
+                    rows.insert(rows.end(), block.row_data(i),
+                                block.row_data(i) + n + 1);
+                }
+            },
+            unlimited, streaming);
+        matnxm<scalar_type> D(count, n, 1);
+        for (size_t i = 0; i < count; i++) {
+            std::copy_n(rows.data() + i * (n + 1), n + 1, D.row_data(i));
+        }
+        std::ostringstream direction;
+        direction << "direction " << c;
+        r.expect(
+            same_rows(fm, polyhedron<scalar_type>::augmented(std::move(D))),
+            "stream_project", in.name, direction.str());
+    }
+}
+
+/**
+ * @brief Saída de uma execução do programa principal.
+ */
+struct execution {
+    bool ok = false;
+    std::string out;
+    std::string err;
+};
+
+static std::string read_file(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << stream.rdbuf();
+    return contents.str();
+}
+
+/**
+ * @brief Executa um processo, guardando as suas saídas em arquivos de um
+ * diretório temporário.
+ */
+static execution run(const std::string& directory,
+                     const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    std::string out = directory + "/stdout", err = directory + "/stderr";
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, out.c_str(),
+                                     O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, err.c_str(),
+                                     O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+    execution result;
+    pid_t pid;
+    int error = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(),
+                            environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+        result.err = "cannot run " + args[0] + ": " + std::strerror(error);
+        return result;
+    }
+
+    int status;
+    result.ok = ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+                WEXITSTATUS(status) == 0;
+    result.out = read_file(out);
+    result.err = read_file(err);
+    return result;
+}
+
+/**
+ * @brief Remove as linhas das projeções de uma saída, mantendo os
+ * cabeçalhos, os poliedros de entrada e os testes de vazio.
+ */
+static std::string skeleton(const std::string& output) {
+    std::istringstream lines(output);
+    std::string result;
+    bool projection = false;
+    for (std::string line; std::getline(lines, line);) {
+        if (line.compare(0, 13, "Projected on ") == 0) {
+            projection = true;
+        } else if (line.empty()) {
+            projection = false;
+        } else if (projection) {
+            continue;
+        }
+        result += line + "\n";
+    }
+    return result;
+}
+
+/**
+ * @brief Remove um diretório e os arquivos dentro dele.
+ */
+static void remove_directory(const std::string& path) {
+    if (DIR* dir = ::opendir(path.c_str())) {
+        while (dirent* entry = ::readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                ::unlink((path + "/" + name).c_str());
+            }
+        }
+        ::closedir(dir);
+    }
+    ::rmdir(path.c_str());
+}
+
+/**
+ * @brief Compara as saídas do programa principal em cada modo com a saída de
+ * `--engine=fm`.
+ *
+ * Os modos que devem reproduzir a referência byte a byte são comparados
+ * diretamente; entre eles, a leitura em trechos de uma linha força o caminho
+ * de vários trechos em qualquer número de processadores. Os modos que
+ * normalizam as linhas são exibidos com poucos dígitos, e só os cabeçalhos,
+ * os poliedros lidos e os testes de vazio são comparados (as linhas são
+ * comparadas em precisão total por `check_library`).
+ */
+static void check_program(const options& opts, const std::string& file,
+                          const std::string& directory, report& r) {
+    auto program = [&](std::vector<std::string> args) {
+        args.insert(args.begin(), {opts.program, "--engine=fm"});
+        args.push_back(file);
+        return run(directory, args);
+    };
+
+    execution reference = program({"--no-cache"});
+    r.expect(reference.ok, "--engine=fm", file, reference.err);
+
+    static const std::vector<std::vector<std::string>> EXACT = {
+        {"--stream"},
+        {"--stream=1", "--jobs=3"},
+        {"--filtered"},
+        {"--filtered=float"},
+        {"--jobs=1"},
+        {"--jobs=3"},
+        {"--parse-chunk=1", "--jobs=3"},
+        {"--parse-chunk=7", "--jobs=2"},
+    };
+    static const std::vector<std::vector<std::string>> ROUNDED = {
+        {"--engine=dd"},
+        {"--out-of-core"},
+        {"--out-of-core=4096"},
+        {"--processes=2"},
+    };
+
+    auto name = [](const std::vector<std::string>& args) {
+        std::string joined;
+        for (const auto& arg : args) {
+            joined += (joined.empty() ? "" : " ") + arg;
+        }
+        return joined;
+    };
+
+    for (const auto& mode : EXACT) {
+        std::vector<std::string> args = {"--no-cache"};
+        args.insert(args.end(), mode.begin(), mode.end());
+        execution e = program(args);
+        r.expect(e.ok && e.out == reference.out, name(mode), file, e.err);
+    }
+    for (const auto& mode : ROUNDED) {
+        std::vector<std::string> args = {"--no-cache"};
+        args.insert(args.end(), mode.begin(), mode.end());
+        execution e = program(args);
+        r.expect(e.ok && skeleton(e.out) == skeleton(reference.out),
+                 name(mode), file, e.err);
+    }
+
+    // Cache: a primeira execução guarda os resultados; a segunda só reproduz
+    // a referência com `--max-rows=1` se todos vierem do cache; a última
+    // recalcula os acertos e não deve encontrar entradas divergentes.
+    std::string cache = "--cache-dir=" + directory + "/cache";
+    execution miss = program({cache});
+    r.expect(miss.ok && miss.out == reference.out, "cache miss", file,
+             miss.err);
+    execution hit = program({cache, "--max-rows=1"});
+    r.expect(hit.ok && hit.out == reference.out, "cache hit", file, hit.err);
+    execution verify = program({cache, "--cache-verify"});
+    r.expect(verify.ok && verify.out == reference.out &&
+                 verify.err.find("stale entry") == std::string::npos,
+             "cache verify", file, verify.err);
+    remove_directory(directory + "/cache");
+}
+
+/**
+ * @brief Exibe as instruções de uso do programa.
+ */
+static void usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] files..." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --program=PATH    also compare the modes of the program "
+                 "at PATH"
+              << std::endl;
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (arg.compare(0, 2, "--") != 0) {
+            opts.files.push_back(arg);
+        } else if (name == "--program" && !value.empty()) {
+            opts.program = value;
+        } else {
+            std::cerr << "invalid option: " << arg << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (opts.files.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    char temporary[] = "/tmp/combpol-check-XXXXXX";
+    if (!opts.program.empty() && ::mkdtemp(temporary) == nullptr) {
+        std::cerr << "cannot create temporary directory" << std::endl;
+        return 1;
+    }
+
+    report r;
+    for (const auto& in : regressions()) {
+        check_library(in, r);
+    }
+    for (const auto& file : opts.files) {
+        try {
+            check_library(read_input(file), r);
+        } catch (std::exception& ex) {
+            r.expect(false, "library", file, ex.what());
+        }
+        if (!opts.program.empty()) {
+            check_program(opts, file, temporary, r);
+        }
+    }
+    if (!opts.program.empty()) {
+        ::unlink((std::string(temporary) + "/stdout").c_str());
+        ::unlink((std::string(temporary) + "/stderr").c_str());
+        ::rmdir(temporary);
+    }
+
+    std::cout << r.checks() << " checks, " << r.failures() << " failures"
+              << std::endl;
+    return r.failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,400 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <io.hpp>
+#include <io/binary.hpp>
+
+using namespace io;
+
+/**
+ * @brief Opções de linha de comando.
+ */
+struct options {
+    // Modelos gerados: "cut", "flow" ou "all".
+    std::string model = "all";
+
+    // Instâncias com mais arestas são ignoradas.
+    size_t max_edges = 100;
+
+    // Número máximo de direções de projeção por arquivo.
+    size_t directions = 8;
+
+    // Diretório de saída (vazio para escrever na saída padrão).
+    std::string output;
+
+    // Se verdadeiro, escreve o formato binário (sem as direções).
+    bool binary = false;
+
+    // Arquivos .stp de entrada.
+    std::vector<std::string> files;
+};
+
+/**
+ * @brief Grafo de uma instância do problema de Steiner em grafos, com vértices
+ * numerados a partir de 0.
+ */
+struct graph {
+    std::string name;
+    size_t nodes = 0;
+    std::vector<std::pair<size_t, size_t>> edges;
+    std::vector<size_t> terminals;
+};
+
+/**
+ * @brief Lê uma instância no formato STP da SteinLIB.
+ *
+ * Somente as seções `Graph` (vértices e arestas; os pesos são ignorados) e
+ * `Terminals` são interpretadas. As palavras-chave não diferenciam maiúsculas
+ * de minúsculas.
+ *
+ * @param filename Nome do arquivo.
+ * @return graph O grafo da instância.
+ */
+static graph read_stp(const std::string& filename) {
+    std::ifstream stream(filename);
+    if (!stream) {
+        throw std::runtime_error("cannot open " + filename);
+    }
+
+    graph G;
+    auto slash = filename.find_last_of('/');
+    G.name = filename.substr(slash == std::string::npos ? 0 : slash + 1);
+    G.name = G.name.substr(0, G.name.rfind('.'));
+
+    auto fail = [&](size_t line, const std::string& message) {
+        throw std::runtime_error(filename + ":" + std::to_string(line) + ": " +
+                                 message);
+    };
+
+    std::string line, section;
+    bool header = false;
+    for (size_t number = 1; std::getline(stream, line); number++) {
+        std::istringstream tokens(line);
+        std::string keyword;
+        if (!(tokens >> keyword)) {
+            continue;
+        }
+        std::transform(keyword.begin(), keyword.end(), keyword.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+
+        if (!header) {
+            if (keyword != "33d32945") {
+                fail(number, "not an STP file");
+            }
+            header = true;
+        } else if (keyword == "eof") {
+            break;
+        } else if (keyword == "section") {
+            tokens >> section;
+            std::transform(section.begin(), section.end(), section.begin(),
+                           [](unsigned char c) { return std::tolower(c); });
+        } else if (keyword == "end") {
+            section.clear();
+        } else if (section == "graph" && keyword == "nodes") {
+            tokens >> G.nodes;
+        } else if (section == "graph" && (keyword == "e" || keyword == "a")) {
+            size_t u, v;
+            if (!(tokens >> u >> v) || u == 0 || v == 0 || u > G.nodes ||
+                v > G.nodes) {
+                fail(number, "invalid edge");
+            }
+            G.edges.emplace_back(u - 1, v - 1);
+        } else if (section == "terminals" && keyword == "t") {
+            size_t t;
+            if (!(tokens >> t) || t == 0 || t > G.nodes) {
+                fail(number, "invalid terminal");
+            }
+            G.terminals.push_back(t - 1);
+        }
+    }
+    if (!header) {
+        fail(1, "not an STP file");
+    }
+    return G;
+}
+
+/**
+ * @brief Sistema de desigualdades densas construído linha a linha.
+ */
+class inequalities {
+  private:
+    size_t m_cols;
+    std::vector<double> m_lhs;
+    std::vector<double> m_rhs;
+
+  public:
+    explicit inequalities(size_t cols) : m_cols(cols) {}
+
+    /**
+     * @brief Adiciona a linha 0 x <= rhs.
+     *
+     * @return double* Os coeficientes da linha, que podem ser preenchidos
+     * até a próxima chamada.
+     */
+    double* add(double rhs) {
+        m_lhs.resize(m_lhs.size() + m_cols);
+        m_rhs.push_back(rhs);
+        return m_lhs.data() + m_lhs.size() - m_cols;
+    }
+
+    polyhedron<double> build() const {
+        matnxm<double> A(m_rhs.size(), m_cols);
+        vecn<double> b(m_rhs.size());
+        for (size_t i = 0; i < m_rhs.size(); i++) {
+            std::copy_n(m_lhs.data() + i * m_cols, m_cols, A.row_data(i));
+            b.unchecked_at(i) = m_rhs[i];
+        }
+        return {std::move(A), std::move(b)};
+    }
+};
+
+/**
+ * @brief Relaxação de cortes do problema de Steiner: uma variável
+ * 0 <= x_e <= 1 por aresta e os cortes x(δ(S)) >= 1 de conjuntos S que
+ * separam um terminal da raiz (o primeiro terminal), para S = {t} e
+ * S = {t, v} com v vizinho de t.
+ *
+ * As direções de projeção são as das variáveis de aresta.
+ */
+static polyhedron<double> cut_model(const graph& G,
+                                    std::vector<size_t>& variables) {
+    size_t m = G.edges.size();
+    inequalities S(m);
+    for (size_t e = 0; e < m; e++) {
+        S.add(1)[e] = 1;
+        S.add(0)[e] = -1;
+    }
+
+    std::vector<char> inside(G.nodes);
+    auto cut = [&]() {
+        double* a = S.add(-1);
+        for (size_t e = 0; e < m; e++) {
+            if (inside[G.edges[e].first] != inside[G.edges[e].second]) {
+                a[e] = -1;
+            }
+        }
+    };
+
+    size_t root = G.terminals[0];
+    for (size_t k = 1; k < G.terminals.size(); k++) {
+        size_t t = G.terminals[k];
+        inside[t] = 1;
+        cut();
+        for (const auto& edge : G.edges) {
+            size_t v = edge.first == t ? edge.second : edge.first;
+            if ((edge.first == t || edge.second == t) && v != root &&
+                v != t) {
+                inside[v] = 1;
+                cut();
+                inside[v] = 0;
+            }
+        }
+        inside[t] = 0;
+    }
+
+    for (size_t e = 0; e < m; e++) {
+        variables.push_back(e);
+    }
+    return S.build();
+}
+
+/**
+ * @brief Relaxação de fluxo (uma só comodidade) do problema de Steiner: a raiz
+ * envia uma unidade de fluxo para cada um dos demais k - 1 terminais, e o
+ * fluxo nos arcos (u, v) e (v, u) de uma aresta é limitado por (k - 1) x_e.
+ *
+ * As variáveis são x_e (uma por aresta) seguidas dos fluxos f_uv e f_vu de
+ * cada aresta. A conservação de fluxo é escrita como duas desigualdades por
+ * vértice. As direções de projeção são as das variáveis de fluxo, cuja
+ * eliminação leva à relaxação de cortes.
+ */
+static polyhedron<double> flow_model(const graph& G,
+                                     std::vector<size_t>& variables) {
+    size_t m = G.edges.size();
+    double demand = double(G.terminals.size() - 1);
+    inequalities S(3 * m);
+
+    for (size_t e = 0; e < m; e++) {
+        S.add(1)[e] = 1;
+        S.add(0)[e] = -1;
+        for (size_t arc = m + 2 * e; arc < m + 2 * e + 2; arc++) {
+            S.add(0)[arc] = -1;
+            double* a = S.add(0);
+            a[arc] = 1;
+            a[e] = -demand;
+        }
+    }
+
+    // Fluxo líquido que entra em cada vértice.
+    std::vector<double> net(G.nodes);
+    net[G.terminals[0]] = -demand;
+    for (size_t k = 1; k < G.terminals.size(); k++) {
+        net[G.terminals[k]] = 1;
+    }
+    for (size_t v = 0; v < G.nodes; v++) {
+        double* in = S.add(net[v]);
+        double* out = S.add(-net[v]);
+        for (size_t e = 0; e < m; e++) {
+            // f_uv entra em v se v é o segundo vértice da aresta, e f_vu se
+            // v é o primeiro.
+            size_t uv = m + 2 * e, vu = uv + 1;
+            double sign = (G.edges[e].second == v) - (G.edges[e].first == v);
+            in[uv] += sign;
+            in[vu] -= sign;
+            out[uv] -= sign;
+            out[vu] += sign;
+        }
+    }
+
+    for (size_t arc = m; arc < 3 * m; arc++) {
+        variables.push_back(arc);
+    }
+    return S.build();
+}
+
+/**
+ * @brief Escreve um poliedro e as direções dos eixos de algumas variáveis,
+ * escolhidas a intervalos regulares, no formato de entrada do programa.
+ */
+static void write_workload(std::ostream& os, const polyhedron<double>& P,
+                           const std::vector<size_t>& variables,
+                           size_t directions) {
+    os << P << std::endl;
+    size_t count = std::min(directions, variables.size());
+    for (size_t k = 0; k < count; k++) {
+        vecn<double> d(P.dimensions());
+        d.unchecked_at(variables[k * variables.size() / count]) = 1;
+        os << d << std::endl;
+    }
+}
+
+/**
+ * @brief Exibe as instruções de uso do programa.
+ */
+static void usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] files.stp..."
+              << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --model=M         cut, flow or all (default: all)"
+              << std::endl
+              << "  --max-edges=N     skip larger instances (default: 100)"
+              << std::endl
+              << "  --directions=N    projection directions per file "
+                 "(default: 8)"
+              << std::endl
+              << "  --output=DIR      write DIR/<instance>-<model>.in "
+                 "(default: standard output)"
+              << std::endl
+              << "  --binary          write the binary format, without "
+                 "directions (requires --output)"
+              << std::endl;
+}
+
+static bool parse_size(const std::string& value, size_t& output) {
+    char* end;
+    output = std::strtoull(value.c_str(), &end, 10);
+    return !value.empty() && *end == '\0';
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        bool ok = true;
+        if (arg.compare(0, 2, "--") != 0) {
+            opts.files.push_back(arg);
+        } else if (name == "--model" &&
+                   (value == "cut" || value == "flow" || value == "all")) {
+            opts.model = value;
+        } else if (name == "--max-edges") {
+            ok = parse_size(value, opts.max_edges);
+        } else if (name == "--directions") {
+            ok = parse_size(value, opts.directions);
+        } else if (name == "--output" && !value.empty()) {
+            opts.output = value;
+        } else if (arg == "--binary") {
+            opts.binary = true;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "invalid option: " << arg << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (opts.files.empty() || (opts.binary && opts.output.empty())) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    using model = polyhedron<double> (*)(const graph&, std::vector<size_t>&);
+    std::vector<std::pair<std::string, model>> models;
+    if (opts.model != "flow") {
+        models.emplace_back("cut", cut_model);
+    }
+    if (opts.model != "cut") {
+        models.emplace_back("flow", flow_model);
+    }
+
+    size_t written = 0, skipped = 0;
+    for (const auto& filename : opts.files) {
+        graph G;
+        try {
+            G = read_stp(filename);
+        } catch (std::runtime_error& ex) {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+
+        if (G.edges.size() > opts.max_edges || G.terminals.size() < 2) {
+            skipped++;
+            continue;
+        }
+
+        for (const auto& entry : models) {
+            std::vector<size_t> variables;
+            polyhedron<double> P = entry.second(G, variables);
+
+            if (opts.output.empty()) {
+                write_workload(std::cout, P, variables, opts.directions);
+                continue;
+            }
+
+            std::string path = opts.output + "/" + G.name + "-" +
+                               entry.first + (opts.binary ? ".bin" : ".in");
+            std::ofstream stream(path, std::ios::binary);
+            if (opts.binary) {
+                binary::write_polyhedron(stream, P);
+            } else {
+                write_workload(stream, P, variables, opts.directions);
+            }
+            if (!stream) {
+                std::cerr << "cannot write " << path << std::endl;
+                return 1;
+            }
+            written++;
+        }
+    }
+
+    if (!opts.output.empty()) {
+        std::cerr << written << " files written to " << opts.output << ", "
+                  << skipped << " instances skipped" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#ifndef __BENCH_GENERATORS__
+#define __BENCH_GENERATORS__
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include <linalg.hpp>
+#include <polyhedral.hpp>
+
+namespace bench {
+using namespace linalg;
+using namespace polyhedral;
+
+/**
+ * @brief Gera o hipercubo [-1, 1]^n, com 2n desigualdades.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param n Número de dimensões.
+ * @return polyhedron<F> O hipercubo.
+ */
+template <typename F> polyhedron<F> hypercube(size_t n) {
+    matnxm<F> A(2 * n, n);
+    vecn<F> b(2 * n);
+    for (size_t j = 0; j < n; j++) {
+        A(2 * j, j) = 1;
+        A(2 * j + 1, j) = -1;
+        b[2 * j] = b[2 * j + 1] = 1;
+    }
+    return {std::move(A), std::move(b)};
+}
+
+/**
+ * @brief Gera o politopo cruzado {x : ±x_1 ± ... ± x_n <= 1}, com 2^n
+ * desigualdades.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param n Número de dimensões.
+ * @return polyhedron<F> O politopo cruzado.
+ */
+template <typename F> polyhedron<F> cross_polytope(size_t n) {
+    size_t m = size_t(1) << n;
+    matnxm<F> A(m, n);
+    vecn<F> b(m);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            A(i, j) = (i >> j) & 1 ? -1 : 1;
+        }
+        b[i] = 1;
+    }
+    return {std::move(A), std::move(b)};
+}
+
+/**
+ * @brief Gera um sistema aleatório não-vazio com m desigualdades em n
+ * variáveis.
+ *
+ * Os coeficientes são inteiros em [-9, 9], e cada coeficiente é não-nulo com
+ * probabilidade `density`. O lado direito é escolhido de forma que um ponto
+ * aleatório x0 satisfaça todas as desigualdades com folga.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param m Número de desigualdades.
+ * @param n Número de variáveis.
+ * @param density Fração esperada de coeficientes não-nulos.
+ * @param seed Semente do gerador de números aleatórios.
+ * @return polyhedron<F> O poliedro gerado.
+ */
+template <typename F>
+polyhedron<F> random_system(size_t m, size_t n, double density,
+                            std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> coefficient(1, 9), slack(1, 10),
+        coordinate(-5, 5);
+    std::bernoulli_distribution nonzero(density), negative(0.5);
+
+    vecn<F> x0(n);
+    for (size_t j = 0; j < n; j++) {
+        x0[j] = coordinate(rng);
+    }
+
+    matnxm<F> A(m, n);
+    vecn<F> b(m);
+    for (size_t i = 0; i < m; i++) {
+        F dot = 0;
+        for (size_t j = 0; j < n; j++) {
+            if (nonzero(rng)) {
+                A(i, j) = negative(rng) ? -coefficient(rng) : coefficient(rng);
+                dot += A(i, j) * x0[j];
+            }
+        }
+        b[i] = dot + slack(rng);
+    }
+    return {std::move(A), std::move(b)};
+}
+
+/**
+ * @brief Gera o dual de um politopo cíclico: as m desigualdades
+ * t_k x_1 + t_k^2 x_2 + ... + t_k^n x_n <= 1, com t_k igualmente espaçados
+ * em [-1, 1].
+ *
+ * Todas as desigualdades são facetas, o que torna o sistema um caso difícil
+ * para a eliminação.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param m Número de desigualdades.
+ * @param n Número de variáveis.
+ * @return polyhedron<F> O poliedro gerado.
+ */
+template <typename F> polyhedron<F> cyclic(size_t m, size_t n) {
+    matnxm<F> A(m, n);
+    vecn<F> b(m);
+    for (size_t k = 0; k < m; k++) {
+        F t = m == 1 ? 0 : F(-1) + F(2 * k) / F(m - 1), power = 1;
+        for (size_t j = 0; j < n; j++) {
+            power *= t;
+            A(k, j) = power;
+        }
+        b[k] = 1;
+    }
+    return {std::move(A), std::move(b)};
+}
+
+/**
+ * @brief Torna um sistema vazio, adicionando uma desigualdade que contradiz a
+ * soma das duas primeiras por uma margem `delta`:
+ * -(a_1 + a_2) x <= -(b_1 + b_2) - delta.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param P Poliedro com ao menos duas desigualdades.
+ * @param delta Margem positiva.
+ * @return polyhedron<F> Um poliedro vazio.
+ */
+template <typename F>
+polyhedron<F> infeasible_perturbation(const polyhedron<F>& P, F delta) {
+    const auto& A = P.A();
+    const auto& b = P.b();
+    size_t m = A.rows(), n = A.cols();
+
+    matnxm<F> D(m + 1, n);
+    vecn<F> d(m + 1);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            D(i, j) = A(i, j);
+        }
+        d[i] = b[i];
+    }
+    for (size_t j = 0; j < n; j++) {
+        D(m, j) = -(A(0, j) + A(1, j));
+    }
+    d[m] = -(b[0] + b[1]) - delta;
+    return {std::move(D), std::move(d)};
+}
+}; // namespace bench
+
+#endif // __BENCH_GENERATORS__
@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <io/protocol.hpp>
+
+extern char** environ;
+
+using namespace io;
+
+/**
+ * @brief Opções de linha de comando.
+ */
+struct options {
+    // Executável do programa principal, iniciado em modo servidor (vazio para
+    // usar um servidor já em execução).
+    std::string server;
+
+    // Socket Unix do servidor.
+    std::string socket_path;
+
+    // Número de clientes simultâneos.
+    size_t clients = 4;
+
+    // Número total de requisições.
+    size_t requests = 1000;
+
+    // Se verdadeiro, mede também uma execução do programa por requisição.
+    bool baseline = false;
+
+    // Arquivos de entrada, enviados em rodízio.
+    std::vector<std::string> files;
+};
+
+/**
+ * @brief Resultado de uma medição: latência de cada requisição e tempo total.
+ */
+struct result {
+    std::string mode;
+    std::vector<double> latencies;
+    double seconds = 0;
+    size_t failures = 0;
+
+    double percentile(double p) const {
+        if (latencies.empty()) {
+            return 0;
+        }
+        std::vector<double> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[std::min(sorted.size() - 1,
+                               size_t(p * (sorted.size() - 1) + 0.5))];
+    }
+};
+
+/**
+ * @brief Distribui `opts.requests` requisições entre `opts.clients` threads,
+ * medindo a latência de cada uma.
+ *
+ * @param send Função que executa a requisição `k` para o cliente `c`,
+ * retornando false em caso de falha.
+ */
+template <typename Send>
+static result run_clients(const options& opts, const std::string& mode,
+                          Send&& send) {
+    result r;
+    r.mode = mode;
+
+    std::atomic<size_t> next(0), failures(0);
+    std::vector<std::vector<double>> latencies(opts.clients);
+    std::vector<std::thread> clients;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < opts.clients; c++) {
+        clients.emplace_back([&, c]() {
+            for (size_t k; (k = next++) < opts.requests;) {
+                auto begin = std::chrono::steady_clock::now();
+                if (!send(c, k)) {
+                    failures++;
+                }
+                std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - begin;
+                latencies[c].push_back(elapsed.count());
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    r.seconds = elapsed.count();
+    r.failures = failures;
+    for (const auto& l : latencies) {
+        r.latencies.insert(r.latencies.end(), l.begin(), l.end());
+    }
+    return r;
+}
+
+/**
+ * @brief Mede requisições a um servidor, uma conexão por cliente.
+ */
+static result bench_server(const options& opts,
+                           const std::vector<protocol::request>& requests) {
+    std::vector<int> connections;
+    for (size_t c = 0; c < opts.clients; c++) {
+        connections.push_back(protocol::connect_unix(opts.socket_path));
+    }
+
+    auto r = run_clients(opts, "server", [&](size_t c, size_t k) {
+        protocol::channel ch(connections[c], connections[c]);
+        protocol::response res;
+        try {
+            protocol::write_request(ch, requests[k % requests.size()]);
+            protocol::read_response(ch, res);
+            return true;
+        } catch (protocol::protocol_error& ex) {
+            std::cerr << ex.what() << std::endl;
+            return false;
+        }
+    });
+
+    for (int fd : connections) {
+        ::close(fd);
+    }
+    return r;
+}
+
+/**
+ * @brief Executa um processo e espera o seu término.
+ *
+ * @return true se o processo terminou com sucesso.
+ */
+static bool spawn_and_wait(const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null",
+                                     O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null",
+                                     O_WRONLY, 0);
+
+    pid_t pid;
+    int error = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(),
+                            environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+        return false;
+    }
+
+    int status;
+    return ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+           WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief Mede uma execução do programa por requisição, como feito por um
+ * script que o chama para cada entrada.
+ */
+static result bench_spawn(const options& opts) {
+    return run_clients(opts, "process", [&](size_t, size_t k) {
+        return spawn_and_wait(
+            {opts.server, "--jobs=1", opts.files[k % opts.files.size()]});
+    });
+}
+
+/**
+ * @brief Inicia o servidor e espera até que ele aceite conexões.
+ *
+ * @return PID do servidor.
+ */
+static pid_t start_server(const options& opts) {
+    std::vector<std::string> args = {opts.server,
+                                     "--serve=" + opts.socket_path};
+    std::vector<char*> argv;
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    ::unlink(opts.socket_path.c_str());
+    pid_t pid;
+    if (posix_spawn(&pid, argv[0], nullptr, nullptr, argv.data(), environ) !=
+        0) {
+        throw protocol::protocol_error("cannot start " + opts.server);
+    }
+
+    for (int attempt = 0; attempt < 500; attempt++) {
+        try {
+            ::close(protocol::connect_unix(opts.socket_path));
+            return pid;
+        } catch (protocol::protocol_error&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ::kill(pid, SIGKILL);
+    throw protocol::protocol_error("server did not start");
+}
+
+static void write_result(std::ostream& os, const result& r) {
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "%-8s %8zu %10.1f %10.3f %10.3f %10.3f %8zu", r.mode.c_str(),
+                  r.latencies.size(), r.latencies.size() / r.seconds,
+                  r.percentile(0.5) * 1e3, r.percentile(0.95) * 1e3,
+                  r.percentile(0.99) * 1e3, r.failures);
+    os << line << std::endl;
+}
+
+/**
+ * @brief Exibe as instruções de uso do programa.
+ */
+static void usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] files..." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --server=PATH     start PATH --serve=SOCKET for the "
+                 "benchmark"
+              << std::endl
+              << "  --socket=PATH     server socket (default: a temporary "
+                 "path)"
+              << std::endl
+              << "  --clients=N       concurrent clients (default: 4)"
+              << std::endl
+              << "  --requests=N      total requests (default: 1000)"
+              << std::endl
+              << "  --baseline        also run one process per request "
+                 "(requires --server)"
+              << std::endl;
+}
+
+static bool parse_size(const std::string& value, size_t& output) {
+    char* end;
+    output = std::strtoull(value.c_str(), &end, 10);
+    return !value.empty() && *end == '\0' && output > 0;
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        bool ok = true;
+        if (arg.compare(0, 2, "--") != 0) {
+            opts.files.push_back(arg);
+        } else if (name == "--server" && !value.empty()) {
+            opts.server = value;
+        } else if (name == "--socket" && !value.empty()) {
+            opts.socket_path = value;
+        } else if (name == "--clients") {
+            ok = parse_size(value, opts.clients);
+        } else if (name == "--requests") {
+            ok = parse_size(value, opts.requests);
+        } else if (arg == "--baseline") {
+            opts.baseline = true;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "invalid option: " << arg << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (opts.files.empty() ||
+        (opts.server.empty() && opts.socket_path.empty()) ||
+        (opts.baseline && opts.server.empty())) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (opts.socket_path.empty()) {
+        opts.socket_path =
+            "/tmp/combpol-load-" + std::to_string(::getpid()) + ".sock";
+    }
+
+    std::vector<protocol::request> requests;
+    for (const auto& filename : opts.files) {
+        std::ifstream stream(filename);
+        std::ostringstream body;
+        body << stream.rdbuf();
+
+        protocol::request req;
+        req.name = filename;
+        req.body = body.str();
+        requests.push_back(std::move(req));
+    }
+
+    std::vector<result> results;
+    try {
+        pid_t server = opts.server.empty() ? 0 : start_server(opts);
+        results.push_back(bench_server(opts, requests));
+        if (server != 0) {
+            int status;
+            ::kill(server, SIGTERM);
+            ::waitpid(server, &status, 0);
+        }
+    } catch (protocol::protocol_error& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (opts.baseline) {
+        results.push_back(bench_spawn(opts));
+    }
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-8s %8s %10s %10s %10s %10s %8s",
+                  "mode", "requests", "req/s", "p50 (ms)", "p95 (ms)",
+                  "p99 (ms)", "failures");
+    std::cout << line << std::endl;
+    for (const auto& r : results) {
+        write_result(std::cout, r);
+    }
+
+    return 0;
+}
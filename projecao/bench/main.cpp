@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <io.hpp>
+#include <linalg.hpp>
+#include <polyhedral.hpp>
+
+#include "allocations.hpp"
+#include "generators.hpp"
+
+using namespace io;
+using namespace linalg;
+using namespace polyhedral;
+
+// Tipo de escalar.
+using scalar_type = double;
+
+//==============================================================================
+// Medições
+//==============================================================================
+
+/**
+ * @brief Reinicia o pico de memória residente do processo, se o sistema
+ * permitir (Linux, via /proc/self/clear_refs).
+ */
+static void reset_peak_rss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5" << std::flush;
+}
+
+/**
+ * @brief Pico de memória residente do processo, em KiB, desde o último
+ * `reset_peak_rss`. Sem /proc, é o pico desde o início do processo.
+ */
+static size_t peak_rss_kib() {
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10);
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Resultado de um caso de benchmark.
+ */
+struct result {
+    std::string name;
+    std::string operation;
+    size_t rows = 0;
+    size_t cols = 0;
+
+    // Número de linhas produzidas em cada passo de eliminação.
+    std::vector<size_t> step_rows;
+
+    // Tempos de cada repetição, em segundos.
+    std::vector<double> seconds;
+
+    size_t peak_rss_kib = 0;
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+
+    // "ok", ou a mensagem do orçamento excedido.
+    std::string status = "ok";
+
+    double min() const {
+        return *std::min_element(seconds.begin(), seconds.end());
+    }
+
+    double median() const {
+        std::vector<double> sorted = seconds;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[sorted.size() / 2];
+    }
+};
+
+/**
+ * @brief Opções de linha de comando.
+ */
+struct options {
+    // Número de repetições de cada caso.
+    size_t repeat = 3;
+
+    // Se verdadeiro, usa instâncias menores.
+    bool quick = false;
+
+    // Executa apenas os casos cujo nome contém o filtro.
+    std::string filter;
+
+    // Arquivo de saída dos resultados em JSON (vazio para não escrever).
+    std::string output;
+
+    // Limites de recursos de cada execução.
+    resource_limits limits;
+};
+
+/**
+ * @brief Mede um caso de benchmark.
+ *
+ * A primeira repetição também mede o pico de memória, as alocações e as linhas
+ * geradas em cada passo de eliminação. Se o orçamento for excedido, o caso é
+ * interrompido e a mensagem é registrada.
+ *
+ * @param opts Opções de linha de comando.
+ * @param out Resultado, com nome, operação e dimensões já preenchidos.
+ * @param body Função que executa o caso com um orçamento.
+ */
+static void measure(const options& opts, result& out,
+                    const std::function<void(budget&)>& body) {
+    for (size_t k = 0; k < opts.repeat; k++) {
+        budget resources(opts.limits);
+        stats_recorder recorder;
+        reset_peak_rss();
+        size_t allocations = bench::allocations(),
+               bytes = bench::allocated_bytes();
+
+        auto start = std::chrono::steady_clock::now();
+        try {
+            if (k == 0) {
+                stats_scope scope(recorder);
+                body(resources);
+            } else {
+                body(resources);
+            }
+        } catch (budget_exceeded& ex) {
+            out.status = ex.what();
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        out.seconds.push_back(elapsed.count());
+        if (k == 0) {
+            out.peak_rss_kib = peak_rss_kib();
+            out.allocations = bench::allocations() - allocations;
+            out.allocated_bytes = bench::allocated_bytes() - bytes;
+            for (const auto& step : recorder.steps()) {
+                out.step_rows.push_back(step.rows);
+            }
+        }
+        if (out.status != "ok") {
+            break;
+        }
+    }
+}
+
+//==============================================================================
+// Casos
+//==============================================================================
+
+/**
+ * @brief Executa os casos de eliminação sobre um poliedro: projeção na
+ * direção (1, ..., 1), colapso da primeira dimensão, projeção nas duas
+ * primeiras coordenadas, teste de vazio e testes de vazio incrementais.
+ */
+static void bench_polyhedron(const options& opts, const std::string& name,
+                             const polyhedron<scalar_type>& P,
+                             std::vector<result>& results) {
+    if (name.find(opts.filter) == std::string::npos) {
+        return;
+    }
+
+    auto make = [&](const char* operation) {
+        result r;
+        r.name = name;
+        r.operation = operation;
+        r.rows = P.A().rows();
+        r.cols = P.A().cols();
+        return r;
+    };
+
+    vecn<scalar_type> direction(P.dimensions());
+    for (size_t j = 0; j < direction.size(); j++) {
+        direction[j] = 1;
+    }
+
+    result project = make("project");
+    measure(opts, project,
+            [&](budget& resources) { P.project(direction, resources); });
+    results.push_back(std::move(project));
+
+    result collapse = make("collapse");
+    measure(opts, collapse,
+            [&](budget& resources) { P.collapse_dimension(0, resources); });
+    results.push_back(std::move(collapse));
+
+    std::vector<size_t> keep = {0, 1};
+    result onto = make("project-onto");
+    measure(opts, onto,
+            [&](budget& resources) { P.project_onto(keep, resources); });
+    results.push_back(std::move(onto));
+
+    result empty = make("empty");
+    measure(opts, empty, [&](budget& resources) { P.empty(resources); });
+    results.push_back(std::move(empty));
+
+    result filtered = make("filtered-empty");
+    measure(opts, filtered,
+            [&](budget& resources) { filtered_empty(P, resources); });
+    results.push_back(std::move(filtered));
+
+    result screened = make("screened-empty");
+    measure(opts, screened,
+            [&](budget& resources) { screened_empty(P, resources); });
+    results.push_back(std::move(screened));
+
+    // Metade das linhas de uma vez e as demais uma a uma, com um teste de
+    // vazio após cada adição.
+    result incremental = make("incremental");
+    measure(opts, incremental, [&](budget& resources) {
+        incremental_polyhedron<scalar_type> I(P.dimensions());
+        size_t half = P.A().rows() / 2;
+        for (size_t i = 0; i < P.A().rows(); i++) {
+            I.add(P.A().row_data(i), P.b().unchecked_at(i));
+            if (i + 1 >= half) {
+                I.empty(resources);
+            }
+        }
+    });
+    results.push_back(std::move(incremental));
+}
+
+/**
+ * @brief Mede a leitura de um poliedro em formato texto, como feita pelo
+ * programa principal.
+ */
+static void bench_parser(const options& opts, const std::string& name,
+                         const polyhedron<scalar_type>& P,
+                         std::vector<result>& results) {
+    if (name.find(opts.filter) == std::string::npos) {
+        return;
+    }
+
+    std::ostringstream text;
+    text << P;
+    const std::string input = text.str();
+
+    result r;
+    r.name = name;
+    r.operation = "parse";
+    r.rows = P.A().rows();
+    r.cols = P.A().cols();
+
+    measure(opts, r, [&](budget&) {
+        std::istringstream stream(input);
+        parser::linear_inequality<scalar_type> inequality;
+        size_t lineno = 1, parsed = 0;
+        for (std::string line; std::getline(stream, line); lineno++) {
+            parser::parser<scalar_type>(name.c_str(), lineno, line.begin(),
+                                        line.end())
+                .parse_linear_inequality(line.begin(), line.end(),
+                                         inequality);
+            inequality.lhs.reset();
+            parsed++;
+        }
+        r.step_rows.assign(1, parsed);
+    });
+    results.push_back(std::move(r));
+}
+
+/**
+ * @brief Executa todos os casos.
+ */
+static std::vector<result> run(const options& opts) {
+    std::vector<result> results;
+    bool quick = opts.quick;
+
+    for (size_t n : {size_t(8), size_t(quick ? 12 : 24)}) {
+        bench_polyhedron(opts, "hypercube-" + std::to_string(n),
+                         bench::hypercube<scalar_type>(n), results);
+    }
+
+    for (size_t n : {size_t(3), size_t(4)}) {
+        bench_polyhedron(opts, "cross-polytope-" + std::to_string(n),
+                         bench::cross_polytope<scalar_type>(n), results);
+    }
+
+    size_t dense_m = quick ? 8 : 10, dense_n = 4;
+    auto dense = bench::random_system<scalar_type>(dense_m, dense_n, 1, 1);
+    bench_polyhedron(opts,
+                     "dense-" + std::to_string(dense_m) + "x" +
+                         std::to_string(dense_n),
+                     dense, results);
+
+    size_t sparse_m = quick ? 24 : 32, sparse_n = quick ? 8 : 12;
+    auto sparse =
+        bench::random_system<scalar_type>(sparse_m, sparse_n, 0.15, 2);
+    bench_polyhedron(opts,
+                     "sparse-" + std::to_string(sparse_m) + "x" +
+                         std::to_string(sparse_n),
+                     sparse, results);
+
+    size_t cyclic_m = quick ? 10 : 16, cyclic_n = 4;
+    bench_polyhedron(opts,
+                     "cyclic-" + std::to_string(cyclic_m) + "x" +
+                         std::to_string(cyclic_n),
+                     bench::cyclic<scalar_type>(cyclic_m, cyclic_n), results);
+
+    bench_polyhedron(opts,
+                     "infeasible-sparse-" + std::to_string(sparse_m) + "x" +
+                         std::to_string(sparse_n),
+                     bench::infeasible_perturbation<scalar_type>(sparse, 1),
+                     results);
+
+    size_t text_m = quick ? 2000 : 20000, text_n = 20;
+    bench_parser(opts,
+                 "text-" + std::to_string(text_m) + "x" +
+                     std::to_string(text_n),
+                 bench::random_system<scalar_type>(text_m, text_n, 0.5, 3),
+                 results);
+
+    return results;
+}
+
+//==============================================================================
+// Saída
+//==============================================================================
+
+/**
+ * @brief Escapa uma string para JSON.
+ */
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+/**
+ * @brief Escreve os resultados em JSON, com um caso por linha para facilitar
+ * a comparação entre execuções.
+ */
+static void write_json(std::ostream& os, const options& opts,
+                       const std::vector<result>& results) {
+    os << "{\"version\": 1, \"repeat\": " << opts.repeat
+       << ", \"quick\": " << (opts.quick ? "true" : "false")
+       << ", \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        os << "  {\"name\": " << json_string(r.name)
+           << ", \"operation\": " << json_string(r.operation)
+           << ", \"rows\": " << r.rows << ", \"cols\": " << r.cols
+           << ", \"step_rows\": [";
+        for (size_t k = 0; k < r.step_rows.size(); k++) {
+            os << (k ? ", " : "") << r.step_rows[k];
+        }
+        os << "], \"seconds_min\": " << r.min()
+           << ", \"seconds_median\": " << r.median()
+           << ", \"peak_rss_kib\": " << r.peak_rss_kib
+           << ", \"allocations\": " << r.allocations
+           << ", \"allocated_bytes\": " << r.allocated_bytes
+           << ", \"status\": " << json_string(r.status) << "}"
+           << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    os << "]}" << std::endl;
+}
+
+/**
+ * @brief Escreve um resumo dos resultados em uma tabela.
+ */
+static void write_table(std::ostream& os, const std::vector<result>& results) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %-14s %8s %12s %10s %10s  %s",
+                  "case", "operation", "rows", "median (s)", "rss (KiB)",
+                  "allocs", "rows/step");
+    os << line << std::endl;
+
+    for (const auto& r : results) {
+        std::snprintf(line, sizeof(line), "%-24s %-14s %8zu %12.6f %10zu %10zu",
+                      r.name.c_str(), r.operation.c_str(), r.rows, r.median(),
+                      r.peak_rss_kib, r.allocations);
+        os << line << " ";
+        for (size_t k = 0; k < r.step_rows.size(); k++) {
+            os << " " << r.step_rows[k];
+        }
+        if (r.status != "ok") {
+            os << "  [" << r.status << "]";
+        }
+        os << std::endl;
+    }
+}
+
+/**
+ * @brief Exibe as instruções de uso do programa.
+ */
+static void usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]" << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --repeat=N      time each case N times (default: 3)"
+              << std::endl
+              << "  --quick         use smaller instances" << std::endl
+              << "  --filter=TEXT   run only cases whose name contains TEXT"
+              << std::endl
+              << "  --output=FILE   write results as JSON to FILE" << std::endl
+              << "  --max-rows=N    abort eliminations generating more than N "
+                 "rows (default: 4000000)"
+              << std::endl;
+}
+
+/**
+ * @brief Lê uma opção de linha de comando.
+ *
+ * @param arg Argumento, no formato `--nome` ou `--nome=valor`.
+ * @param opts Opções de saída.
+ * @return true se a opção for válida.
+ * @return false caso contrário.
+ */
+static bool parse_option(const std::string& arg, options& opts) {
+    auto eq = arg.find('=');
+    std::string name = arg.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+    char* end = nullptr;
+    if (name == "--repeat" && !value.empty()) {
+        opts.repeat = std::strtoull(value.c_str(), &end, 10);
+        return *end == '\0' && opts.repeat > 0;
+    } else if (name == "--max-rows" && !value.empty()) {
+        opts.limits.max_rows = std::strtoull(value.c_str(), &end, 10);
+        return *end == '\0';
+    } else if (name == "--filter" && !value.empty()) {
+        opts.filter = value;
+    } else if (name == "--output" && !value.empty()) {
+        opts.output = value;
+    } else if (name == "--quick" && eq == std::string::npos) {
+        opts.quick = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    opts.limits.max_rows = 4000000;
+
+    for (int i = 1; i < argc; i++) {
+        if (!parse_option(argv[i], opts)) {
+            std::cerr << "invalid option: " << argv[i] << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    auto results = run(opts);
+    write_table(std::cout, results);
+
+    if (!opts.output.empty()) {
+        std::ofstream output(opts.output);
+        write_json(output, opts, results);
+        if (!output) {
+            std::cerr << "cannot write " << opts.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+#ifndef __CONCURRENT_BOUNDED_QUEUE__
+#define __CONCURRENT_BOUNDED_QUEUE__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <internal.hpp>
+
+namespace concurrent {
+
+/**
+ * @brief Fila limitada, sem travas, com múltiplos produtores e múltiplos
+ * consumidores (algoritmo de D. Vyukov).
+ *
+ * Cada posição do buffer circular tem um número de sequência que indica se ela
+ * está livre para o produtor ou ocupada para o consumidor da volta atual, de
+ * forma que produtores e consumidores só disputam os contadores de cabeça e
+ * cauda (com compare-and-swap), nunca uma trava.
+ *
+ * As operações bloqueantes (`push` e `pop`) esperam girando e cedendo o
+ * processador por algumas tentativas e, depois disso, dormem em uma variável
+ * de condição até que o outro lado as acorde. Quem insere ou remove um
+ * elemento só toma a trava da variável de condição se há alguém dormindo.
+ *
+ * @tparam T Tipo de elemento.
+ */
+template <typename T> class bounded_queue {
+  private:
+    struct cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // Evita que os contadores de produtores e consumidores compartilhem uma
+    // linha de cache.
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::unique_ptr<cell[]> m_cells;
+    size_t m_mask;
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail;
+    alignas(CACHE_LINE) std::atomic<size_t> m_head;
+    alignas(CACHE_LINE) std::atomic<bool> m_closed;
+
+    // Número de produtores e consumidores dormindo nas variáveis de condição.
+    alignas(CACHE_LINE) std::atomic<size_t> m_parked_producers;
+    std::atomic<size_t> m_parked_consumers;
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+
+  public:
+    /**
+     * @brief Constrói uma fila vazia.
+     *
+     * @param capacity Número máximo de elementos; deve ser uma potência de 2
+     * maior ou igual a 2.
+     */
+    explicit bounded_queue(size_t capacity)
+        : m_cells(new cell[capacity]), m_mask(capacity - 1), m_tail(0),
+          m_head(0), m_closed(false), m_parked_producers(0),
+          m_parked_consumers(0) {
+        internal::validate(
+            "queue capacity must be a power of two greater than one", [&]() {
+                return capacity >= 2 && (capacity & (capacity - 1)) == 0;
+            });
+
+        for (size_t i = 0; i < capacity; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bounded_queue(const bounded_queue&) = delete;
+    bounded_queue& operator=(const bounded_queue&) = delete;
+
+    /**
+     * @brief Tenta inserir um elemento no fim da fila.
+     *
+     * @param value Elemento; só é movido se a inserção for bem-sucedida.
+     * @return true se o elemento foi inserido.
+     * @return false se a fila estava cheia.
+     */
+    bool try_push(T& value) {
+        if (!enqueue(value)) {
+            return false;
+        }
+        wake(m_parked_consumers, m_not_empty);
+        return true;
+    }
+
+    /**
+     * @brief Tenta remover o elemento do início da fila.
+     *
+     * @param value Referência de saída para o elemento.
+     * @return true se um elemento foi removido.
+     * @return false se a fila estava vazia.
+     */
+    bool try_pop(T& value) {
+        if (!dequeue(value)) {
+            return false;
+        }
+        wake(m_parked_producers, m_not_full);
+        return true;
+    }
+
+    /**
+     * @brief Insere um elemento no fim da fila, esperando enquanto ela estiver
+     * cheia.
+     *
+     * @param value Elemento.
+     */
+    void push(T value) {
+        for (backoff wait; !enqueue(value);) {
+            if (!wait()) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                parked sleeper(m_parked_producers);
+                while (!enqueue(value)) {
+                    m_not_full.wait(lock);
+                }
+                break;
+            }
+        }
+        wake(m_parked_consumers, m_not_empty);
+    }
+
+    /**
+     * @brief Remove o elemento do início da fila, esperando enquanto ela
+     * estiver vazia e aberta.
+     *
+     * @param value Referência de saída para o elemento.
+     * @return true se um elemento foi removido.
+     * @return false se a fila está vazia e foi fechada.
+     */
+    bool pop(T& value) {
+        bool popped = false;
+        for (backoff wait; !(popped = dequeue(value));) {
+            // Todo `push` anterior ao `close` é visível depois de observarmos
+            // a fila fechada, então uma última tentativa decide se a fila
+            // terminou.
+            if (closed()) {
+                popped = dequeue(value);
+                break;
+            }
+            if (!wait()) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                parked sleeper(m_parked_consumers);
+                while (!(popped = dequeue(value)) && !closed()) {
+                    m_not_empty.wait(lock);
+                }
+                if (!popped) {
+                    popped = dequeue(value);
+                }
+                break;
+            }
+        }
+        if (popped) {
+            wake(m_parked_producers, m_not_full);
+        }
+        return popped;
+    }
+
+    /**
+     * @brief Fecha a fila: depois que os elementos restantes forem removidos,
+     * `pop` retorna false. Não deve haver `push` depois do fechamento.
+     */
+    void close() {
+        m_closed.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_not_empty.notify_all();
+    }
+
+  private:
+    bool closed() const { return m_closed.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Insere um elemento sem acordar consumidores (vide `try_push`).
+     */
+    bool enqueue(T& value) {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            cell& c = m_cells[position & m_mask];
+            size_t sequence = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                        static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+                    c.value = std::move(value);
+                    c.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove um elemento sem acordar produtores (vide `try_pop`).
+     */
+    bool dequeue(T& value) {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            cell& c = m_cells[position & m_mask];
+            size_t sequence = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                        static_cast<std::ptrdiff_t>(position + 1);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+                    value = std::move(c.value);
+                    c.sequence.store(position + m_mask + 1,
+                                     std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Acorda um dos produtores ou consumidores dormindo em uma variável
+     * de condição, se houver algum.
+     *
+     * A barreira pareia com a de `parked`: ou quem dorme vê o elemento
+     * inserido (ou removido) na sua última tentativa, ou vê-se aqui o contador
+     * não nulo. Tomar a trava garante que a notificação não acontece entre a
+     * última tentativa e o início da espera.
+     */
+    void wake(std::atomic<size_t>& parked, std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked.load(std::memory_order_relaxed) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+            }
+            cv.notify_one();
+        }
+    }
+
+    /**
+     * @brief Registra uma thread dormindo enquanto o objeto existe.
+     */
+    class parked {
+      private:
+        std::atomic<size_t>& m_count;
+
+      public:
+        explicit parked(std::atomic<size_t>& count) : m_count(count) {
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        ~parked() { m_count.fetch_sub(1, std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief Espera progressiva entre tentativas de uma operação bloqueante,
+     * antes de dormir.
+     */
+    class backoff {
+      private:
+        unsigned m_attempt = 0;
+
+      public:
+        /**
+         * @return false se as tentativas acabaram e a thread deve dormir.
+         */
+        bool operator()() {
+            if (m_attempt < 64) {
+                // Espera curta: o outro lado provavelmente está no meio de uma
+                // operação.
+            } else if (m_attempt < 128) {
+                std::this_thread::yield();
+            } else {
+                return false;
+            }
+            m_attempt++;
+            return true;
+        }
+    };
+};
+}; // namespace concurrent
+
+#endif // __CONCURRENT_BOUNDED_QUEUE__
@@ -39,6 +39,43 @@ std::ostream&& operator<<(std::ostream&& os, const vecn<F>& vec) {
     return std::move(os << vec);
 }
 
+/**
+ * @brief Escreve uma desigualdade linear `lhs x <= rhs` em uma linha de uma
+ * stream.
+ *
+ * @tparam Row Tipo de vetor, linha de matriz ou ponteiro para os coeficientes.
+ * @tparam F Tipo de escalar.
+ *
+ * @param os Stream de saída.
+ * @param lhs Coeficientes da desigualdade.
+ * @param n Número de coeficientes.
+ * @param rhs Lado direito da desigualdade.
+ *
+ * @return std::ostream& Uma referência para a stream.
+ */
+template <typename Row, typename F>
+std::ostream& write_inequality(std::ostream& os, const Row& lhs, size_t n,
+                               F rhs) {
+    bool zero = true;
+    for (size_t j = 0; j < n; j++) {
+        if (lhs[j] == 0) {
+            continue;
+        }
+        if (!zero) {
+            os << " + ";
+        }
+        os << lhs[j] << "x" << (j + 1);
+        zero = false;
+    }
+    if (zero) {
+        os << "0 ";
+    }
+    os << " <= ";
+    os << rhs;
+    os << std::endl;
+    return os;
+}
+
 /**
  * @brief Escreve um poliedro em uma stream.
  *
@@ -58,24 +95,8 @@ std::ostream& operator<<(std::ostream& os, const polyhedron<F>& P) {
     }
 
     for (size_t i = 0; i < P.A().rows(); i++) {
-        auto row = P.A()[i];
-        bool zero = true;
-        for (size_t j = 0; j < row.size(); j++) {
-            if (row[j] == 0) {
-                continue;
-            }
-            if (!zero) {
-                os << " + ";
-            }
-            os << row[j] << "x" << (j + 1);
-            zero = false;
-        }
-        if (zero) {
-            os << "0 ";
-        }
-        os << " <= ";
-        os << P.b()[i];
-        os << std::endl;
+        write_inequality(os, P.A().row_data(i), P.A().cols(),
+                         P.b().unchecked_at(i));
     }
     return os;
 }
@@ -85,6 +106,36 @@ std::ostream&& operator<<(std::ostream&& os, const polyhedron<F>& P) {
     return std::move(os << P);
 }
 
+/**
+ * @brief Escreve um poliedro armazenado em disco em uma stream, uma linha por
+ * vez.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param os Stream de saída.
+ * @param P Poliedro.
+ *
+ * @return std::ostream& Uma referência para a stream.
+ */
+template <typename F>
+std::ostream& operator<<(std::ostream& os, const external_polyhedron<F>& P) {
+    // Se a matriz for vazia, escreve uma tautologia.
+    if (P.rows() == 0 || P.dimensions() == 0) {
+        os << "0 <= 0" << std::endl;
+        return os;
+    }
+
+    P.for_each_row([&](const F* lhs, F rhs) {
+        write_inequality(os, lhs, P.dimensions(), rhs);
+    });
+    return os;
+}
+
+template <typename F>
+std::ostream&& operator<<(std::ostream&& os, const external_polyhedron<F>& P) {
+    return std::move(os << P);
+}
+
 }; // namespace io
 
 #endif // __CLI_HPP__
@@ -0,0 +1,170 @@
+#ifndef __BINARY_HPP__
+#define __BINARY_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <linalg.hpp>
+#include <polyhedral.hpp>
+
+namespace io {
+namespace binary {
+using namespace linalg;
+using namespace polyhedral;
+
+/**
+ * @brief Classe para um erro de leitura de dados binários.
+ */
+class format_error : public std::runtime_error {
+  public:
+    explicit format_error(const std::string& message)
+        : std::runtime_error("binary format error: " + message) {}
+};
+
+/**
+ * @brief Cabeçalho do formato binário de poliedros.
+ *
+ * O cabeçalho é seguido de `rows` linhas, cada uma com `cols + 1` escalares:
+ * os coeficientes a_i seguidos de b_i. Todos os valores são escritos na ordem
+ * de bytes nativa.
+ */
+struct header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t scalar_size;
+    std::uint32_t reserved;
+    std::uint64_t rows;
+    std::uint64_t cols;
+};
+
+static constexpr char MAGIC[4] = {'C', 'P', 'L', 'Y'};
+static constexpr char POINTS_MAGIC[4] = {'C', 'P', 'T', 'S'};
+static constexpr std::uint32_t VERSION = 1;
+
+/**
+ * @brief Escreve um poliedro em uma stream no formato binário.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param os Stream de saída.
+ * @param P Poliedro.
+ */
+template <typename F>
+void write_polyhedron(std::ostream& os, const polyhedron<F>& P) {
+    const auto& A = P.A();
+    const auto& b = P.b();
+
+    header h;
+    std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.scalar_size = sizeof(F);
+    h.reserved = 0;
+    h.rows = A.rows();
+    h.cols = A.cols();
+    os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    std::vector<F> row(A.cols() + 1);
+    for (size_t i = 0; i < A.rows(); i++) {
+        std::copy(A.row_data(i), A.row_data(i) + A.cols(), row.begin());
+        row[A.cols()] = b.unchecked_at(i);
+        os.write(reinterpret_cast<const char*>(row.data()),
+                 row.size() * sizeof(F));
+    }
+}
+
+/**
+ * @brief Lê um poliedro no formato binário de uma stream.
+ *
+ * @tparam F Tipo de escalar.
+ *
+ * @param is Stream de entrada.
+ * @return polyhedron<F> O poliedro lido.
+ */
+template <typename F> polyhedron<F> read_polyhedron(std::istream& is) {
+    header h;
+    if (!is.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+        throw format_error("truncated header");
+    }
+    if (std::memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0) {
+        throw format_error("bad magic number");
+    }
+    if (h.version != VERSION) {
+        throw format_error("unsupported version " + std::to_string(h.version));
+    }
+    if (h.scalar_size != sizeof(F)) {
+        throw format_error("scalar size mismatch");
+    }
+
+    matnxm<F> A(h.rows, h.cols);
+    vecn<F> b(h.rows);
+
+    std::vector<F> row(h.cols + 1);
+    for (size_t i = 0; i < h.rows; i++) {
+        if (!is.read(reinterpret_cast<char*>(row.data()),
+                     row.size() * sizeof(F))) {
+            throw format_error("truncated row " + std::to_string(i));
+        }
+        std::copy(row.begin(), row.begin() + h.cols, A.row_data(i));
+        b.unchecked_at(i) = row[h.cols];
+    }
+
+    return {std::move(A), std::move(b)};
+}
+
+/**
+ * @brief Destino de pontos no formato binário (vide `polyhedral::sample`).
+ *
+ * O formato usa o mesmo cabeçalho dos poliedros, com o número mágico
+ * `POINTS_MAGIC`, seguido de `rows` pontos com `cols` escalares cada.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class point_writer {
+  private:
+    std::ostream& m_os;
+    size_t m_cols;
+
+  public:
+    /**
+     * @brief Escreve o cabeçalho de um arquivo de pontos.
+     *
+     * @param os Stream de saída.
+     * @param rows Número de pontos que serão escritos.
+     * @param cols Número de coordenadas de cada ponto.
+     */
+    point_writer(std::ostream& os, size_t rows, size_t cols)
+        : m_os(os), m_cols(cols) {
+        header h;
+        std::memcpy(h.magic, POINTS_MAGIC, sizeof(h.magic));
+        h.version = VERSION;
+        h.scalar_size = sizeof(F);
+        h.reserved = 0;
+        h.rows = rows;
+        h.cols = cols;
+        m_os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    }
+
+    /**
+     * @brief Escreve um lote de pontos consecutivos.
+     *
+     * @param points Coordenadas dos pontos, um após o outro.
+     * @param count Número de pontos.
+     */
+    void operator()(const F* points, size_t count) {
+        m_os.write(reinterpret_cast<const char*>(points),
+                   count * m_cols * sizeof(F));
+        if (!m_os) {
+            throw format_error("cannot write points");
+        }
+    }
+};
+
+}; // namespace binary
+}; // namespace io
+
+#endif // __BINARY_HPP__
@@ -0,0 +1,520 @@
+#ifndef __CACHE_HPP__
+#define __CACHE_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <linalg.hpp>
+#include <polyhedral.hpp>
+
+#include <io/binary.hpp>
+
+namespace io {
+using namespace linalg;
+using namespace polyhedral;
+
+/**
+ * @brief Chave de conteúdo: a sequência canônica dos bytes que identificam uma
+ * entrada, e o seu hash (FNV-1a de 64 bits), que dá o nome da entrada.
+ */
+class content_key {
+  private:
+    std::string m_bytes;
+
+  public:
+    /**
+     * @brief Adiciona uma sequência de bytes à chave.
+     *
+     * @param data Ponteiro para os bytes.
+     * @param size Número de bytes.
+     */
+    void update(const void* data, size_t size) {
+        m_bytes.append(static_cast<const char*>(data), size);
+    }
+
+    /**
+     * @brief Adiciona uma string à chave, incluindo seu tamanho.
+     *
+     * @param value String.
+     */
+    void update(const std::string& value) {
+        update(std::uint64_t(value.size()));
+        update(value.data(), value.size());
+    }
+
+    /**
+     * @brief Adiciona um valor escalar à chave.
+     *
+     * Zeros são normalizados, de forma que -0.0 e 0.0 têm a mesma chave.
+     *
+     * @tparam T Tipo do valor.
+     * @param value Valor.
+     */
+    template <typename T> void update(T value) {
+        static_assert(std::is_arithmetic<T>::value,
+                      "only arithmetic values can be hashed by value");
+        if (value == T(0)) {
+            value = T(0);
+        }
+        update(&value, sizeof(value));
+    }
+
+    /**
+     * @brief Bytes da chave.
+     */
+    const std::string& bytes() const { return m_bytes; }
+
+    /**
+     * @brief Valor do hash.
+     *
+     * @return std::uint64_t O hash dos dados adicionados até agora.
+     */
+    std::uint64_t digest() const {
+        std::uint64_t state = 14695981039346656037ull;
+        for (unsigned char byte : m_bytes) {
+            state ^= byte;
+            state *= 1099511628211ull;
+        }
+        return state;
+    }
+};
+
+/**
+ * @brief Cache persistente de resultados de teste de vazio e projeção.
+ *
+ * Cada resultado é guardado em um arquivo próprio em um diretório local, com
+ * nome dado pelo hash da chave da entrada (A, b, direção, tipo de escalar e
+ * opções do algoritmo). A chave completa é guardada na entrada e comparada a
+ * cada acerto, de forma que colisões do hash são tratadas como falhas. Quando
+ * o tamanho total das entradas excede o limite configurado, as entradas usadas
+ * há mais tempo são removidas.
+ *
+ * Nos testes de vazio, cujo resultado não depende da escala das linhas, a
+ * chave usa as linhas normalizadas (vide `normalize`). Nas projeções, cujas
+ * linhas dependem da escala das linhas de entrada, a chave usa as linhas
+ * exatas.
+ *
+ * Falhas de leitura ou escrita no cache nunca interrompem o processamento: a
+ * entrada correspondente é simplesmente tratada como ausente.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class result_cache {
+  private:
+    // Versão do formato das entradas; alterá-la invalida o cache existente.
+    static constexpr std::uint32_t FORMAT_VERSION = 2;
+
+    static constexpr std::uint32_t KIND_EMPTY = 0;
+    static constexpr std::uint32_t KIND_PROJECTION = 1;
+
+    std::string m_directory;
+    size_t m_max_bytes;
+    bool m_verify;
+    std::string m_options;
+
+    // Protege o tamanho total das entradas, que é atualizado por cada escrita
+    // (o cache pode ser usado por várias threads).
+    std::mutex m_mutex;
+    size_t m_total_bytes = 0;
+
+    // Distingue os arquivos temporários de escritas concorrentes no processo.
+    std::atomic<size_t> m_temporaries{0};
+
+  public:
+    /**
+     * @brief Abre (criando, se necessário) um cache em um diretório.
+     *
+     * @param directory Diretório do cache.
+     * @param max_bytes Tamanho máximo, em bytes, das entradas do cache.
+     * @param verify Se verdadeiro, todo acerto é recalculado e comparado com o
+     * valor guardado, que é substituído caso seja diferente.
+     * @param options Descrição das opções do algoritmo que afetam o resultado.
+     */
+    result_cache(std::string directory, size_t max_bytes, bool verify,
+                 std::string options)
+        : m_directory(std::move(directory)), m_max_bytes(max_bytes),
+          m_verify(verify), m_options(std::move(options)) {
+        make_directories(m_directory);
+        for (const auto& entry : list_entries()) {
+            m_total_bytes += entry.size;
+        }
+    }
+
+    /**
+     * @brief Determina se um poliedro é vazio, consultando o cache.
+     *
+     * @tparam Compute Tipo da função que calcula o resultado.
+     *
+     * @param P Poliedro.
+     * @param compute Função que calcula o resultado em caso de falha no cache.
+     * @return bool O resultado de `compute()`.
+     */
+    template <typename Compute>
+    bool empty(const polyhedron<F>& P, Compute compute) {
+        content_key key = entry_key(KIND_EMPTY, P, true);
+        auto path = entry_path(key);
+
+        std::ifstream is(path, std::ios::binary);
+        char cached;
+        if (read_entry_header(is, KIND_EMPTY, key) && is.get(cached)) {
+            touch(path);
+            if (!m_verify) {
+                return cached != 0;
+            }
+
+            bool result = compute();
+            if (result != (cached != 0)) {
+                stale(path);
+                store(path, KIND_EMPTY, key, [&](std::ostream& os) {
+                    os.put(result ? 1 : 0);
+                });
+            }
+            return result;
+        }
+
+        bool result = compute();
+        store(path, KIND_EMPTY, key,
+              [&](std::ostream& os) { os.put(result ? 1 : 0); });
+        return result;
+    }
+
+    /**
+     * @brief Calcula a projeção de um poliedro em uma direção, consultando o
+     * cache.
+     *
+     * @tparam Compute Tipo da função que calcula o resultado.
+     *
+     * @param P Poliedro.
+     * @param direction Direção da projeção.
+     * @param compute Função que calcula o resultado em caso de falha no cache.
+     * @return polyhedron<F> O resultado de `compute()`.
+     */
+    template <typename Compute>
+    polyhedron<F> project(const polyhedron<F>& P, const vecn<F>& direction,
+                          Compute compute) {
+        content_key key = entry_key(KIND_PROJECTION, P, false);
+        key.update(std::uint64_t(direction.size()));
+        for (size_t j = 0; j < direction.size(); j++) {
+            key.update(direction[j]);
+        }
+        auto path = entry_path(key);
+
+        std::ifstream is(path, std::ios::binary);
+        if (read_entry_header(is, KIND_PROJECTION, key)) {
+            try {
+                polyhedron<F> cached = binary::read_polyhedron<F>(is);
+                touch(path);
+                if (!m_verify) {
+                    return cached;
+                }
+
+                polyhedron<F> result = compute();
+                if (!equal(result, cached)) {
+                    stale(path);
+                    store(path, KIND_PROJECTION, key, [&](std::ostream& os) {
+                        binary::write_polyhedron(os, result);
+                    });
+                }
+                return result;
+            } catch (binary::format_error&) {
+                // Entradas corrompidas são tratadas como ausentes.
+            }
+        }
+
+        polyhedron<F> result = compute();
+        store(path, KIND_PROJECTION, key, [&](std::ostream& os) {
+            binary::write_polyhedron(os, result);
+        });
+        return result;
+    }
+
+  private:
+    struct entry {
+        std::string path;
+        size_t size;
+        struct timespec mtime;
+    };
+
+    /**
+     * @brief Inicia a chave de uma entrada com as informações comuns a todo
+     * tipo de resultado e o conteúdo de um poliedro.
+     *
+     * @param normalized Se verdadeiro, as linhas são normalizadas antes de
+     * entrarem na chave.
+     */
+    content_key entry_key(std::uint32_t kind, const polyhedron<F>& P,
+                          bool normalized) const {
+        content_key key;
+        key.update(FORMAT_VERSION);
+        key.update(kind);
+        key.update(std::string(typeid(F).name()));
+        key.update(m_options);
+
+        const auto& A = P.A();
+        size_t width = A.cols() + 1;
+        key.update(std::uint64_t(A.rows()));
+        key.update(std::uint64_t(A.cols()));
+        std::vector<F> row(width);
+        for (size_t i = 0; i < A.rows(); i++) {
+            // A linha aumentada [a_i | b_i] guarda b_i depois de a_i.
+            std::copy_n(A.row_data(i), width, row.begin());
+            if (normalized) {
+                normalize(row.data(), width);
+            }
+            for (F value : row) {
+                key.update(value);
+            }
+        }
+        return key;
+    }
+
+    /**
+     * @brief Normaliza uma linha [a_i | b_i] por um fator positivo exato: o
+     * máximo divisor comum dos escalares, para escalares inteiros, ou uma
+     * potência de 2 que leva o maior escalar em módulo a [0.5, 1), para
+     * escalares de ponto flutuante. O sinal não é alterado, pois determina o
+     * sentido da desigualdade.
+     */
+    static void normalize(F* row, size_t width) {
+        normalize(row, width, std::is_floating_point<F>());
+    }
+
+    static void normalize(F* row, size_t width, std::true_type) {
+        F scale = 0;
+        for (size_t j = 0; j < width; j++) {
+            scale = std::max(scale, std::abs(row[j]));
+        }
+        if (scale == 0 || !std::isfinite(scale)) {
+            return;
+        }
+
+        int exponent;
+        std::frexp(scale, &exponent);
+        for (size_t j = 0; j < width; j++) {
+            row[j] = std::ldexp(row[j], -exponent);
+        }
+    }
+
+    static void normalize(F* row, size_t width, std::false_type) {
+        F divisor = 0;
+        for (size_t j = 0; j < width; j++) {
+            F a = row[j] < 0 ? -row[j] : row[j], b = divisor;
+            while (b != 0) {
+                F r = a % b;
+                a = b;
+                b = r;
+            }
+            divisor = a;
+        }
+        if (divisor > 1) {
+            for (size_t j = 0; j < width; j++) {
+                row[j] /= divisor;
+            }
+        }
+    }
+
+    std::string entry_path(const content_key& key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.entry",
+                      static_cast<unsigned long long>(key.digest()));
+        return m_directory + "/" + name;
+    }
+
+    /**
+     * @brief Lê e valida o cabeçalho de uma entrada, incluindo a sua chave.
+     */
+    static bool read_entry_header(std::istream& is, std::uint32_t kind,
+                                  const content_key& key) {
+        std::uint32_t version, entry_kind;
+        std::uint64_t size;
+        if (!is.read(reinterpret_cast<char*>(&version), sizeof(version)) ||
+            !is.read(reinterpret_cast<char*>(&entry_kind),
+                     sizeof(entry_kind)) ||
+            version != FORMAT_VERSION || entry_kind != kind ||
+            !is.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+            size != key.bytes().size()) {
+            return false;
+        }
+
+        // A chave é comparada em blocos, sem ler a entrada inteira de uma vez.
+        char buffer[4096];
+        for (size_t offset = 0; offset < size; offset += sizeof(buffer)) {
+            size_t count = std::min<size_t>(sizeof(buffer), size - offset);
+            if (!is.read(buffer, count) ||
+                key.bytes().compare(offset, count, buffer, count) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Escreve uma entrada no cache e remove entradas antigas caso o
+     * limite de tamanho seja excedido.
+     *
+     * A entrada é escrita em um arquivo temporário e então renomeada, de forma
+     * que leitores concorrentes nunca vêem uma entrada incompleta.
+     */
+    template <typename Writer>
+    void store(const std::string& path, std::uint32_t kind,
+               const content_key& key, Writer write) {
+        std::string temporary = path + ".tmp" + std::to_string(::getpid()) +
+                                "." + std::to_string(m_temporaries++);
+        {
+            std::ofstream os(temporary, std::ios::binary | std::ios::trunc);
+            std::uint32_t version = FORMAT_VERSION;
+            os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+            os.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+            std::uint64_t size = key.bytes().size();
+            os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            os.write(key.bytes().data(), key.bytes().size());
+            write(os);
+            if (!os) {
+                std::remove(temporary.c_str());
+                return;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        struct stat previous, current;
+        bool replaced = ::stat(path.c_str(), &previous) == 0;
+        if (std::rename(temporary.c_str(), path.c_str()) != 0 ||
+            ::stat(path.c_str(), &current) != 0) {
+            std::remove(temporary.c_str());
+            return;
+        }
+
+        if (replaced) {
+            m_total_bytes -= std::min<size_t>(m_total_bytes, previous.st_size);
+        }
+        m_total_bytes += current.st_size;
+        evict();
+    }
+
+    /**
+     * @brief Remove as entradas usadas há mais tempo até que o tamanho total
+     * do cache esteja dentro do limite.
+     */
+    void evict() {
+        if (m_total_bytes <= m_max_bytes) {
+            return;
+        }
+
+        auto entries = list_entries();
+        std::sort(entries.begin(), entries.end(),
+                  [](const entry& a, const entry& b) {
+                      return a.mtime.tv_sec != b.mtime.tv_sec
+                                 ? a.mtime.tv_sec < b.mtime.tv_sec
+                                 : a.mtime.tv_nsec < b.mtime.tv_nsec;
+                  });
+
+        m_total_bytes = 0;
+        for (const auto& e : entries) {
+            m_total_bytes += e.size;
+        }
+
+        for (const auto& e : entries) {
+            if (m_total_bytes <= m_max_bytes) {
+                break;
+            }
+            if (std::remove(e.path.c_str()) == 0) {
+                m_total_bytes -= e.size;
+            }
+        }
+    }
+
+    /**
+     * @brief Lista as entradas do diretório do cache.
+     */
+    std::vector<entry> list_entries() const {
+        static const char SUFFIX[] = ".entry";
+        static const size_t SUFFIX_LENGTH = sizeof(SUFFIX) - 1;
+
+        std::vector<entry> entries;
+        DIR* dir = ::opendir(m_directory.c_str());
+        if (dir == nullptr) {
+            return entries;
+        }
+
+        while (struct dirent* ent = ::readdir(dir)) {
+            std::string name = ent->d_name;
+            if (name.size() <= SUFFIX_LENGTH ||
+                name.compare(name.size() - SUFFIX_LENGTH, SUFFIX_LENGTH,
+                             SUFFIX) != 0) {
+                continue;
+            }
+
+            std::string path = m_directory + "/" + name;
+            struct stat st;
+            if (::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                entries.push_back({path, size_t(st.st_size), st.st_mtim});
+            }
+        }
+        ::closedir(dir);
+        return entries;
+    }
+
+    /**
+     * @brief Marca uma entrada como usada agora.
+     */
+    static void touch(const std::string& path) {
+        ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+    }
+
+    /**
+     * @brief Reporta uma entrada cujo valor difere do valor recalculado.
+     */
+    static void stale(const std::string& path) {
+        std::cerr << "cache: stale entry " << path << ", replacing"
+                  << std::endl;
+    }
+
+    /**
+     * @brief Determina se dois poliedros têm exatamente as mesmas linhas.
+     */
+    static bool equal(const polyhedron<F>& P, const polyhedron<F>& Q) {
+        if (P.A().rows() != Q.A().rows() || P.A().cols() != Q.A().cols()) {
+            return false;
+        }
+        // As linhas aumentadas [a_i | b_i] são comparadas de uma vez.
+        size_t width = P.A().cols() + 1;
+        for (size_t i = 0; i < P.A().rows(); i++) {
+            const F* p = P.A().row_data(i);
+            if (!std::equal(p, p + width, Q.A().row_data(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Cria um diretório e seus ancestrais, se não existirem.
+     */
+    static void make_directories(const std::string& path) {
+        for (size_t slash = path.find('/', 1); slash != std::string::npos;
+             slash = path.find('/', slash + 1)) {
+            ::mkdir(path.substr(0, slash).c_str(), 0755);
+        }
+        ::mkdir(path.c_str(), 0755);
+    }
+};
+
+}; // namespace io
+
+#endif // __CACHE_HPP__
@@ -0,0 +1,366 @@
+#ifndef __PROTOCOL_HPP__
+#define __PROTOCOL_HPP__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace io {
+namespace protocol {
+
+/**
+ * @brief Classe para um erro de protocolo (mensagem mal formada ou conexão
+ * interrompida no meio de uma mensagem).
+ */
+class protocol_error : public std::runtime_error {
+  public:
+    explicit protocol_error(const std::string& message)
+        : std::runtime_error("protocol error: " + message) {}
+};
+
+// Tamanho máximo do corpo de uma mensagem.
+static constexpr size_t MAX_BODY_SIZE = size_t(1) << 30;
+
+/**
+ * @brief Operação de uma requisição.
+ */
+enum class operation {
+    // Teste de vazio e projeções, como no processamento de um arquivo.
+    RUN,
+
+    // Somente o teste de vazio.
+    EMPTY,
+
+    // Somente as projeções.
+    PROJECT,
+};
+
+/**
+ * @brief Requisição: uma operação sobre um poliedro e direções de projeção,
+ * no formato dos arquivos de entrada.
+ */
+struct request {
+    operation op = operation::RUN;
+    std::string name;
+    std::string body;
+};
+
+/**
+ * @brief Resposta a uma requisição: a saída padrão e a saída de erro que o
+ * processamento de um arquivo com o mesmo conteúdo produziria.
+ */
+struct response {
+    std::string out;
+    std::string err;
+};
+
+inline const char* operation_name(operation op) {
+    switch (op) {
+    case operation::EMPTY:
+        return "empty";
+    case operation::PROJECT:
+        return "project";
+    default:
+        return "run";
+    }
+}
+
+inline bool parse_operation(const std::string& name, operation& op) {
+    for (auto candidate :
+         {operation::RUN, operation::EMPTY, operation::PROJECT}) {
+        if (name == operation_name(candidate)) {
+            op = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Canal de mensagens sobre um descritor de arquivo (um par de pipes ou
+ * um socket), com leitura bufferizada.
+ */
+class channel {
+  private:
+    int m_input;
+    int m_output;
+    std::string m_buffer;
+    size_t m_position = 0;
+
+  public:
+    /**
+     * @brief Constrói um canal. O canal não fecha os descritores.
+     *
+     * @param input Descritor de leitura.
+     * @param output Descritor de escrita.
+     */
+    channel(int input, int output) : m_input(input), m_output(output) {}
+
+    /**
+     * @brief Lê uma linha, sem o '\n'.
+     *
+     * @param line Referência de saída para a linha.
+     * @return false se a entrada terminou antes do início da linha.
+     */
+    bool read_line(std::string& line) {
+        line.clear();
+        for (;;) {
+            auto end = m_buffer.find('\n', m_position);
+            if (end != std::string::npos) {
+                line.append(m_buffer, m_position, end - m_position);
+                m_position = end + 1;
+                return true;
+            }
+
+            line.append(m_buffer, m_position, std::string::npos);
+            m_position = m_buffer.size();
+            if (line.size() > 4096) {
+                throw protocol_error("header line too long");
+            }
+            if (!fill()) {
+                if (line.empty()) {
+                    return false;
+                }
+                throw protocol_error("unterminated header line");
+            }
+        }
+    }
+
+    /**
+     * @brief Lê exatamente `size` bytes.
+     *
+     * @param size Número de bytes.
+     * @param data Referência de saída para os bytes.
+     */
+    void read_exact(size_t size, std::string& data) {
+        data.clear();
+        data.reserve(size);
+        while (data.size() < size) {
+            if (m_position == m_buffer.size() && !fill()) {
+                throw protocol_error("truncated message body");
+            }
+            auto count =
+                std::min(size - data.size(), m_buffer.size() - m_position);
+            data.append(m_buffer, m_position, count);
+            m_position += count;
+        }
+    }
+
+    /**
+     * @brief Escreve uma sequência de bytes.
+     */
+    void write_all(const std::string& data) {
+        const char* pos = data.data();
+        size_t remaining = data.size();
+        while (remaining > 0) {
+            auto count = ::write(m_output, pos, remaining);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                throw protocol_error(std::string("write failed: ") +
+                                     std::strerror(errno));
+            }
+            pos += count;
+            remaining -= count;
+        }
+    }
+
+  private:
+    bool fill() {
+        char chunk[65536];
+        for (;;) {
+            auto count = ::read(m_input, chunk, sizeof(chunk));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                throw protocol_error(std::string("read failed: ") +
+                                     std::strerror(errno));
+            }
+            m_buffer.erase(0, m_position);
+            m_position = 0;
+            m_buffer.append(chunk, count);
+            return count > 0;
+        }
+    }
+};
+
+/**
+ * @brief Lê um tamanho decimal de um cabeçalho.
+ */
+inline size_t parse_length(const std::string& text) {
+    char* end;
+    errno = 0;
+    auto value = std::strtoull(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno != 0 || text[0] == '-' ||
+        value > MAX_BODY_SIZE) {
+        throw protocol_error("invalid length '" + text + "'");
+    }
+    return value;
+}
+
+/**
+ * @brief Separa a próxima palavra de um cabeçalho.
+ */
+inline std::string next_word(const std::string& line, size_t& pos) {
+    auto begin = std::min(line.find_first_not_of(' ', pos), line.size());
+    auto end = std::min(line.find(' ', begin), line.size());
+    pos = end;
+    return line.substr(begin, end - begin);
+}
+
+/**
+ * @brief Lê uma requisição: a linha `<operação> <tamanho> [nome]`, seguida de
+ * `tamanho` bytes de corpo.
+ *
+ * @param ch Canal.
+ * @param req Referência de saída para a requisição.
+ * @return false se a entrada terminou antes da requisição.
+ */
+inline bool read_request(channel& ch, request& req) {
+    std::string line;
+    if (!ch.read_line(line)) {
+        return false;
+    }
+
+    size_t pos = 0;
+    auto op = next_word(line, pos);
+    if (!parse_operation(op, req.op)) {
+        throw protocol_error("unknown operation '" + op + "'");
+    }
+    auto length = parse_length(next_word(line, pos));
+    req.name = next_word(line, pos);
+    if (req.name.empty()) {
+        req.name = "request";
+    }
+
+    ch.read_exact(length, req.body);
+    return true;
+}
+
+/**
+ * @brief Escreve uma requisição.
+ */
+inline void write_request(channel& ch, const request& req) {
+    ch.write_all(std::string(operation_name(req.op)) + " " +
+                 std::to_string(req.body.size()) +
+                 (req.name.empty() ? "" : " " + req.name) + "\n" + req.body);
+}
+
+/**
+ * @brief Lê uma resposta: a linha `ok <tamanho da saída> <tamanho do erro>`,
+ * seguida das duas saídas, ou a linha `error <tamanho>`, seguida da mensagem
+ * de erro.
+ *
+ * @param ch Canal.
+ * @param res Referência de saída para a resposta.
+ */
+inline void read_response(channel& ch, response& res) {
+    std::string line;
+    if (!ch.read_line(line)) {
+        throw protocol_error("connection closed");
+    }
+
+    size_t pos = 0;
+    auto status = next_word(line, pos);
+    if (status == "ok") {
+        auto out = parse_length(next_word(line, pos));
+        auto err = parse_length(next_word(line, pos));
+        ch.read_exact(out, res.out);
+        ch.read_exact(err, res.err);
+    } else if (status == "error") {
+        std::string message;
+        ch.read_exact(parse_length(next_word(line, pos)), message);
+        throw protocol_error(message);
+    } else {
+        throw protocol_error("unknown status '" + status + "'");
+    }
+}
+
+/**
+ * @brief Escreve uma resposta.
+ */
+inline void write_response(channel& ch, const response& res) {
+    ch.write_all("ok " + std::to_string(res.out.size()) + " " +
+                 std::to_string(res.err.size()) + "\n" + res.out + res.err);
+}
+
+/**
+ * @brief Escreve uma resposta de erro de protocolo. Depois dela, o servidor
+ * fecha a conexão.
+ */
+inline void write_error(channel& ch, const std::string& message) {
+    ch.write_all("error " + std::to_string(message.size()) + "\n" + message);
+}
+
+/**
+ * @brief Monta o endereço de um socket Unix.
+ */
+inline sockaddr_un unix_address(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw protocol_error("socket path too long: " + path);
+    }
+    std::strcpy(address.sun_path, path.c_str());
+    return address;
+}
+
+/**
+ * @brief Cria um socket Unix que aceita conexões em um caminho, substituindo
+ * um socket anterior no mesmo caminho.
+ *
+ * @return Descritor do socket.
+ */
+inline int listen_unix(const std::string& path) {
+    auto address = unix_address(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw protocol_error(std::string("socket: ") + std::strerror(errno));
+    }
+
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+            0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw protocol_error("cannot listen on " + path + ": " +
+                             std::strerror(error));
+    }
+    return fd;
+}
+
+/**
+ * @brief Conecta a um socket Unix.
+ *
+ * @return Descritor da conexão.
+ */
+inline int connect_unix(const std::string& path) {
+    auto address = unix_address(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw protocol_error(std::string("socket: ") + std::strerror(errno));
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address),
+                  sizeof(address)) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw protocol_error("cannot connect to " + path + ": " +
+                             std::strerror(error));
+    }
+    return fd;
+}
+}; // namespace protocol
+}; // namespace io
+
+#endif // __PROTOCOL_HPP__
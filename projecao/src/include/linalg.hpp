@@ -1,6 +1,7 @@
 #ifndef __LINALG__
 #define __LINALG__
 
+#include "linalg/expr.hpp"
 #include "linalg/matnxm.hpp"
 #include "linalg/vecn.hpp"
 
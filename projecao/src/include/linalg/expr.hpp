@@ -0,0 +1,302 @@
+#ifndef __LINALG_EXPR__
+#define __LINALG_EXPR__
+
+#include <cstddef>
+#include <type_traits>
+
+#include <internal.hpp>
+
+namespace linalg {
+/**
+ * @brief Base das expressões vetoriais (vetores, linhas e colunas de matrizes
+ * e operações sobre eles).
+ *
+ * Uma expressão `E` tem os membros `scalar_type`, `size()` e
+ * `unchecked_at(i)`. Os operadores aritméticos não calculam nada: eles
+ * constroem uma expressão que é avaliada coordenada a coordenada, em um único
+ * laço, quando atribuída a um vetor ou a uma linha ou coluna de matriz.
+ *
+ * @tparam E Tipo da expressão (CRTP).
+ */
+template <typename E> class vec_expr {
+  public:
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/**
+ * @brief Base das expressões matriciais (matrizes e operações coordenada a
+ * coordenada sobre elas).
+ *
+ * Uma expressão `E` tem os membros `scalar_type`, `rows()`, `cols()` e
+ * `unchecked_at(i, j)`.
+ *
+ * @tparam E Tipo da expressão (CRTP).
+ */
+template <typename E> class mat_expr {
+  public:
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/**
+ * @brief Determina se um tipo é uma expressão vetorial.
+ */
+template <typename T>
+struct is_vec_expr : std::is_base_of<vec_expr<T>, T> {};
+
+/**
+ * @brief Tipo com o qual um operando é guardado em uma expressão.
+ *
+ * Operandos são guardados por valor (expressões e linhas ou colunas de
+ * matrizes são objetos pequenos, e em geral temporários); vetores e matrizes
+ * especializam este template para serem guardados por referência.
+ */
+template <typename T> struct expr_operand { using type = const T; };
+
+/**
+ * @brief Lê uma coordenada de um vetor, linha, coluna ou expressão, sem
+ * verificar o índice se for uma expressão.
+ */
+template <typename VecLike,
+          std::enable_if_t<is_vec_expr<VecLike>::value, int> = 0>
+auto element(const VecLike& v, size_t i) {
+    return v.unchecked_at(i);
+}
+
+template <typename VecLike,
+          std::enable_if_t<!is_vec_expr<VecLike>::value, int> = 0>
+auto element(const VecLike& v, size_t i) {
+    return v[i];
+}
+
+namespace expr {
+struct plus {
+    template <typename F> static F apply(F a, F b) { return a + b; }
+};
+
+struct minus {
+    template <typename F> static F apply(F a, F b) { return a - b; }
+};
+
+/**
+ * @brief Operação coordenada a coordenada entre duas expressões vetoriais.
+ */
+template <typename L, typename R, typename Op>
+class vec_binary : public vec_expr<vec_binary<L, R, Op>> {
+  private:
+    typename expr_operand<L>::type m_lhs;
+    typename expr_operand<R>::type m_rhs;
+
+  public:
+    using scalar_type = typename L::scalar_type;
+
+    vec_binary(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs) {
+        internal::validate("cannot operate on vectors of different sizes",
+                           [&]() { return lhs.size() == rhs.size(); });
+    }
+
+    size_t size() const { return m_lhs.size(); }
+
+    scalar_type unchecked_at(size_t i) const {
+        return Op::apply(scalar_type(m_lhs.unchecked_at(i)),
+                         scalar_type(m_rhs.unchecked_at(i)));
+    }
+
+    scalar_type operator[](size_t i) const {
+        internal::validate("vector index out of bounds",
+                           [&]() { return i < size(); });
+        return unchecked_at(i);
+    }
+};
+
+/**
+ * @brief Produto de uma expressão vetorial por um escalar.
+ */
+template <typename E> class vec_scaled : public vec_expr<vec_scaled<E>> {
+  private:
+    typename expr_operand<E>::type m_expr;
+
+  public:
+    using scalar_type = typename E::scalar_type;
+
+  private:
+    scalar_type m_scalar;
+
+  public:
+    vec_scaled(const E& e, scalar_type scalar) : m_expr(e), m_scalar(scalar) {}
+
+    size_t size() const { return m_expr.size(); }
+
+    scalar_type unchecked_at(size_t i) const {
+        return m_expr.unchecked_at(i) * m_scalar;
+    }
+
+    scalar_type operator[](size_t i) const {
+        internal::validate("vector index out of bounds",
+                           [&]() { return i < size(); });
+        return unchecked_at(i);
+    }
+};
+
+/**
+ * @brief Operação coordenada a coordenada entre duas expressões matriciais.
+ */
+template <typename L, typename R, typename Op>
+class mat_binary : public mat_expr<mat_binary<L, R, Op>> {
+  private:
+    typename expr_operand<L>::type m_lhs;
+    typename expr_operand<R>::type m_rhs;
+
+  public:
+    using scalar_type = typename L::scalar_type;
+
+    mat_binary(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs) {
+        internal::validate("cannot operate on matrices of different sizes",
+                           [&]() {
+                               return lhs.rows() == rhs.rows() &&
+                                      lhs.cols() == rhs.cols();
+                           });
+    }
+
+    size_t rows() const { return m_lhs.rows(); }
+    size_t cols() const { return m_lhs.cols(); }
+
+    scalar_type unchecked_at(size_t i, size_t j) const {
+        return Op::apply(scalar_type(m_lhs.unchecked_at(i, j)),
+                         scalar_type(m_rhs.unchecked_at(i, j)));
+    }
+};
+
+/**
+ * @brief Produto de uma expressão matricial por um escalar.
+ */
+template <typename E> class mat_scaled : public mat_expr<mat_scaled<E>> {
+  private:
+    typename expr_operand<E>::type m_expr;
+
+  public:
+    using scalar_type = typename E::scalar_type;
+
+  private:
+    scalar_type m_scalar;
+
+  public:
+    mat_scaled(const E& e, scalar_type scalar) : m_expr(e), m_scalar(scalar) {}
+
+    size_t rows() const { return m_expr.rows(); }
+    size_t cols() const { return m_expr.cols(); }
+
+    scalar_type unchecked_at(size_t i, size_t j) const {
+        return m_expr.unchecked_at(i, j) * m_scalar;
+    }
+};
+}; // namespace expr
+
+/**
+ * @brief Soma de vetores.
+ */
+template <typename L, typename R>
+expr::vec_binary<L, R, expr::plus> operator+(const vec_expr<L>& lhs,
+                                             const vec_expr<R>& rhs) {
+    return {lhs.self(), rhs.self()};
+}
+
+/**
+ * @brief Diferença de vetores.
+ */
+template <typename L, typename R>
+expr::vec_binary<L, R, expr::minus> operator-(const vec_expr<L>& lhs,
+                                              const vec_expr<R>& rhs) {
+    return {lhs.self(), rhs.self()};
+}
+
+/**
+ * @brief Produto vetor-escalar.
+ */
+template <typename E>
+expr::vec_scaled<E> operator*(const vec_expr<E>& e,
+                              typename E::scalar_type scalar) {
+    return {e.self(), scalar};
+}
+
+/**
+ * @brief Produto escalar-vetor.
+ */
+template <typename E>
+expr::vec_scaled<E> operator*(typename E::scalar_type scalar,
+                              const vec_expr<E>& e) {
+    return {e.self(), scalar};
+}
+
+/**
+ * @brief Inverso aditivo de um vetor.
+ */
+template <typename E> expr::vec_scaled<E> operator-(const vec_expr<E>& e) {
+    return {e.self(), -1};
+}
+
+/**
+ * @brief Produto interno de vetores, calculado imediatamente.
+ *
+ * @return Escalar resultante do produto interno.
+ */
+template <typename L, typename R>
+typename L::scalar_type operator*(const vec_expr<L>& lhs,
+                                  const vec_expr<R>& rhs) {
+    const L& l = lhs.self();
+    const R& r = rhs.self();
+    internal::validate(
+        "cannot take dot product of vectors of different sizes",
+        [&]() { return l.size() == r.size(); });
+
+    typename L::scalar_type result = 0;
+    for (size_t i = 0; i < l.size(); i++) {
+        result += l.unchecked_at(i) * r.unchecked_at(i);
+    }
+    return result;
+}
+
+/**
+ * @brief Soma de matrizes.
+ */
+template <typename L, typename R>
+expr::mat_binary<L, R, expr::plus> operator+(const mat_expr<L>& lhs,
+                                             const mat_expr<R>& rhs) {
+    return {lhs.self(), rhs.self()};
+}
+
+/**
+ * @brief Diferença de matrizes.
+ */
+template <typename L, typename R>
+expr::mat_binary<L, R, expr::minus> operator-(const mat_expr<L>& lhs,
+                                              const mat_expr<R>& rhs) {
+    return {lhs.self(), rhs.self()};
+}
+
+/**
+ * @brief Produto matriz-escalar.
+ */
+template <typename E>
+expr::mat_scaled<E> operator*(const mat_expr<E>& e,
+                              typename E::scalar_type scalar) {
+    return {e.self(), scalar};
+}
+
+/**
+ * @brief Produto escalar-matriz.
+ */
+template <typename E>
+expr::mat_scaled<E> operator*(typename E::scalar_type scalar,
+                              const mat_expr<E>& e) {
+    return {e.self(), scalar};
+}
+
+/**
+ * @brief Inverso aditivo de uma matriz.
+ */
+template <typename E> expr::mat_scaled<E> operator-(const mat_expr<E>& e) {
+    return {e.self(), -1};
+}
+}; // namespace linalg
+
+#endif // __LINALG_EXPR__
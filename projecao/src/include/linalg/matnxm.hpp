@@ -2,13 +2,16 @@
 #define __LINALG_MATNXM__
 
 #include <algorithm>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <type_traits>
 #include <utility>
 
 #include <internal.hpp>
 
+#include "expr.hpp"
 #include "vecn.hpp"
 
 namespace linalg {
@@ -22,16 +25,124 @@ struct all_t {};
  */
 static constexpr all_t all = {};
 
+/**
+ * @brief Iterador de acesso aleatório sobre elementos igualmente espaçados na
+ * memória (e.g. uma coluna de uma matriz armazenada por linhas).
+ *
+ * @tparam T Tipo de elemento (possivelmente const).
+ */
+template <typename T> class strided_iterator {
+  private:
+    T* m_ptr;
+    std::ptrdiff_t m_stride;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_const_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    strided_iterator() : m_ptr(nullptr), m_stride(1) {}
+    strided_iterator(T* ptr, std::ptrdiff_t stride)
+        : m_ptr(ptr), m_stride(stride) {}
+
+    reference operator*() const { return *m_ptr; }
+    pointer operator->() const { return m_ptr; }
+    reference operator[](difference_type n) const {
+        return m_ptr[n * m_stride];
+    }
+
+    strided_iterator& operator++() {
+        m_ptr += m_stride;
+        return *this;
+    }
+    strided_iterator operator++(int) {
+        strided_iterator old = *this;
+        ++*this;
+        return old;
+    }
+    strided_iterator& operator--() {
+        m_ptr -= m_stride;
+        return *this;
+    }
+    strided_iterator operator--(int) {
+        strided_iterator old = *this;
+        --*this;
+        return old;
+    }
+
+    strided_iterator& operator+=(difference_type n) {
+        m_ptr += n * m_stride;
+        return *this;
+    }
+    strided_iterator& operator-=(difference_type n) {
+        m_ptr -= n * m_stride;
+        return *this;
+    }
+    strided_iterator operator+(difference_type n) const {
+        return strided_iterator(*this) += n;
+    }
+    strided_iterator operator-(difference_type n) const {
+        return strided_iterator(*this) -= n;
+    }
+    friend strided_iterator operator+(difference_type n,
+                                      const strided_iterator& it) {
+        return it + n;
+    }
+    difference_type operator-(const strided_iterator& other) const {
+        return (m_ptr - other.m_ptr) / m_stride;
+    }
+
+    bool operator==(const strided_iterator& other) const {
+        return m_ptr == other.m_ptr;
+    }
+    bool operator!=(const strided_iterator& other) const {
+        return m_ptr != other.m_ptr;
+    }
+    bool operator<(const strided_iterator& other) const {
+        return (other - *this) > 0;
+    }
+    bool operator>(const strided_iterator& other) const {
+        return other < *this;
+    }
+    bool operator<=(const strided_iterator& other) const {
+        return !(other < *this);
+    }
+    bool operator>=(const strided_iterator& other) const {
+        return !(*this < other);
+    }
+};
+
 /**
  * @brief Classe para matrizes sobre um corpo F.
  *
+ * Somas e produtos por escalar de matrizes, e de linhas e colunas de matrizes,
+ * são avaliados apenas quando atribuídos (vide `vec_expr` e `mat_expr`).
+ *
+ * As linhas são armazenadas em sequência, a partir de um endereço alinhado a
+ * `ALIGNMENT` bytes, e cada uma ocupa `stride()` escalares: as colunas seguidas
+ * de um preenchimento até um múltiplo de `VECTOR_BYTES` bytes. Assim, todas as
+ * linhas começam alinhadas e os laços sobre elas não têm restos parciais. O
+ * preenchimento pode guardar colunas reservadas (vide `reserved_column`).
+ *
  * @tparam F Tipo de escalar.
  */
-template <typename F> class matnxm {
+template <typename F> class matnxm : public mat_expr<matnxm<F>> {
+  public:
+    // Alinhamento, em bytes, do início da primeira linha (uma linha de cache).
+    static constexpr size_t ALIGNMENT = 64;
+
+    // Largura, em bytes, dos registradores vetoriais para os quais as linhas
+    // são preenchidas.
+    static constexpr size_t VECTOR_BYTES = 32;
+
   private:
-    std::unique_ptr<F[]> m_cells;
-    size_t m_rows;
-    size_t m_cols;
+    std::unique_ptr<F[]> m_storage;
+    F* m_cells = nullptr;
+    size_t m_rows = 0;
+    size_t m_cols = 0;
+    size_t m_stride = 0;
 
   public:
     using scalar_type = F;
@@ -41,7 +152,10 @@ template <typename F> class matnxm {
     /**
      * @brief Classe auxiliar para manipulação de linhas em uma matriz.
      */
-    template <typename MRef> class row_t {
+    template <typename MRef> class row_t : public vec_expr<row_t<MRef>> {
+      public:
+        using scalar_type = F;
+
       private:
         MRef m_matrix;
         size_t m_row;
@@ -53,11 +167,22 @@ template <typename F> class matnxm {
         using reference = std::conditional_t<
             std::is_const<std::remove_reference_t<MRef>>::value,
             matnxm::const_reference, matnxm::reference>;
+        using iterator = std::remove_reference_t<reference>*;
 
         row_t() = delete;
         row_t(const row_t&) = default;
         row_t(row_t&&) = default;
 
+        /**
+         * @brief Células da linha, em posições contíguas de memória.
+         *
+         * @return Ponteiro para a primeira célula da linha.
+         */
+        iterator data() const { return m_matrix.row_data(m_row); }
+
+        iterator begin() const { return data(); }
+        iterator end() const { return data() + size(); }
+
         /**
          * @brief Copia a linha para um vetor.
          *
@@ -65,9 +190,7 @@ template <typename F> class matnxm {
          */
         vecn<scalar_type> vec() const {
             vecn<scalar_type> row(size());
-            for (size_t j = 0; j < size(); j++) {
-                row[j] = m_matrix(m_row, j);
-            }
+            std::copy(begin(), end(), row.begin());
             return row;
         }
 
@@ -112,6 +235,15 @@ template <typename F> class matnxm {
          */
         reference operator[](size_t col) { return m_matrix(m_row, col); }
 
+        /**
+         * @brief Acessa uma coluna da linha sem verificar o índice.
+         *
+         * @param col Coluna a ser acessada.
+         *
+         * @return F Valor da célula correspondente na matriz.
+         */
+        const_reference unchecked_at(size_t col) const { return data()[col]; }
+
         /**
          * @brief Copia um vetor nesta linha, sobrescrevendo a matriz original.
          *
@@ -136,8 +268,9 @@ template <typename F> class matnxm {
                 "cannot assign vector-like to row of different size",
                 [&]() { return size() == other.size(); });
 
+            iterator row = data();
             for (size_t j = 0; j < size(); j++) {
-                this->operator[](j) = other[j];
+                row[j] = element(other, j);
             }
             return *this;
         }
@@ -153,7 +286,11 @@ template <typename F> class matnxm {
     /**
      * @brief Classe auxiliar para manipulação de colunas em uma matriz.
      */
-    template <typename MRef> class column_t {
+    template <typename MRef>
+    class column_t : public vec_expr<column_t<MRef>> {
+      public:
+        using scalar_type = F;
+
       private:
         MRef m_matrix;
         size_t m_col;
@@ -165,11 +302,27 @@ template <typename F> class matnxm {
         using reference = std::conditional_t<
             std::is_const<std::remove_reference_t<MRef>>::value,
             matnxm::const_reference, matnxm::reference>;
+        using iterator =
+            strided_iterator<std::remove_reference_t<reference>>;
 
         column_t() = delete;
         column_t(const column_t&) = default;
         column_t(column_t&&) = default;
 
+        /**
+         * @brief Iterador para a primeira célula da coluna, que avança uma
+         * linha da matriz por vez.
+         */
+        iterator begin() const {
+            return iterator(m_matrix.data() + m_col,
+                            std::ptrdiff_t(m_matrix.stride()));
+        }
+
+        /**
+         * @brief Iterador para depois da última célula da coluna.
+         */
+        iterator end() const { return begin() + size(); }
+
         /**
          * @brief Copia a coluna para um vetor.
          *
@@ -177,9 +330,7 @@ template <typename F> class matnxm {
          */
         vecn<scalar_type> vec() const {
             vecn<scalar_type> col(size());
-            for (size_t i = 0; i < size(); i++) {
-                col[i] = m_matrix(i, m_col);
-            }
+            std::copy(begin(), end(), col.begin());
             return col;
         }
 
@@ -212,7 +363,10 @@ template <typename F> class matnxm {
          * @return F Valor da célula correspondente na matriz.
          */
         const_reference operator[](size_t row) const {
-            return m_matrix(row, m_col);
+            internal::validate("matrix cell out of bounds",
+                               [&]() { return row < size(); });
+
+            return begin()[row];
         }
 
         /**
@@ -222,7 +376,21 @@ template <typename F> class matnxm {
          *
          * @return F& Referência para a célula correspondente na matriz.
          */
-        reference operator[](size_t row) { return m_matrix(row, m_col); }
+        reference operator[](size_t row) {
+            internal::validate("matrix cell out of bounds",
+                               [&]() { return row < size(); });
+
+            return begin()[row];
+        }
+
+        /**
+         * @brief Acessa uma linha da coluna sem verificar o índice.
+         *
+         * @param row Linha a ser acessada.
+         *
+         * @return F Valor da célula correspondente na matriz.
+         */
+        const_reference unchecked_at(size_t row) const { return begin()[row]; }
 
         /**
          * @brief Copia um vetor nesta coluna, sobrescrevendo a matriz original.
@@ -248,8 +416,9 @@ template <typename F> class matnxm {
                 "cannot assign vector-like to column of different size",
                 [&]() { return size() == other.size(); });
 
+            iterator col = begin();
             for (size_t i = 0; i < size(); i++) {
-                this->operator[](i) = other[i];
+                col[i] = element(other, i);
             }
             return *this;
         }
@@ -270,19 +439,56 @@ template <typename F> class matnxm {
 
     matnxm() = default;
 
-    matnxm(matnxm&& other) = default;
-    matnxm& operator=(matnxm&& other) = default;
+    matnxm(matnxm&& other) { *this = std::move(other); }
+
+    matnxm& operator=(matnxm&& other) {
+        m_storage = std::move(other.m_storage);
+        m_cells = std::exchange(other.m_cells, nullptr);
+        m_rows = std::exchange(other.m_rows, 0);
+        m_cols = std::exchange(other.m_cols, 0);
+        m_stride = std::exchange(other.m_stride, 0);
+        return *this;
+    }
 
     matnxm(const matnxm& other) { *this = other; }
 
+    /**
+     * @brief Copia uma matriz, incluindo as suas colunas reservadas.
+     */
     matnxm& operator=(const matnxm& other) {
-        m_rows = other.m_rows;
-        m_cols = other.m_cols;
+        if (this != &other) {
+            allocate(other.m_rows, other.m_cols, other.m_stride);
+            std::copy(other.m_cells, other.m_cells + m_rows * m_stride,
+                      m_cells);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Constrói uma matriz avaliando uma expressão matricial.
+     *
+     * @param e Expressão.
+     */
+    template <typename E> matnxm(const mat_expr<E>& e) {
+        allocate(e.self().rows(), e.self().cols(), padded(e.self().cols()));
+        assign(e.self());
+    }
 
-        auto size = m_rows * m_cols;
-        m_cells = std::make_unique<F[]>(size);
-        std::copy(other.m_cells.get(), other.m_cells.get() + size,
-                  m_cells.get());
+    /**
+     * @brief Avalia uma expressão matricial nesta matriz. A expressão pode
+     * conter a própria matriz, já que cada célula depende apenas das células
+     * de mesma posição dos operandos.
+     *
+     * @param e Expressão.
+     *
+     * @return matnxm& Referência para esta matriz.
+     */
+    template <typename E> matnxm& operator=(const mat_expr<E>& e) {
+        if (e.self().rows() != m_rows || e.self().cols() != m_cols) {
+            matnxm result(e);
+            return *this = std::move(result);
+        }
+        assign(e.self());
         return *this;
     }
 
@@ -292,10 +498,23 @@ template <typename F> class matnxm {
      * @param rows Número de linhas da matriz.
      * @param cols Número de colunas da matriz.
      */
-    matnxm(size_t rows, size_t cols) {
-        m_rows = rows;
-        m_cols = cols;
-        m_cells = std::make_unique<F[]>(rows * cols);
+    matnxm(size_t rows, size_t cols) : matnxm(rows, cols, 0) {}
+
+    /**
+     * @brief Constrói uma matriz zero com `rows` linhas e `cols` colunas, e
+     * pelo menos `reserved` colunas reservadas no preenchimento de cada linha.
+     *
+     * As colunas reservadas não fazem parte da matriz (não contam em `cols()`
+     * nem participam de expressões), mas seguem as colunas da matriz na
+     * memória de cada linha e são preservadas por cópias e atribuições de
+     * expressões de mesmo tamanho.
+     *
+     * @param rows Número de linhas da matriz.
+     * @param cols Número de colunas da matriz.
+     * @param reserved Número de colunas reservadas.
+     */
+    matnxm(size_t rows, size_t cols, size_t reserved) {
+        allocate(rows, cols, padded(cols + reserved));
     }
 
     /**
@@ -312,6 +531,88 @@ template <typename F> class matnxm {
      */
     size_t cols() const { return m_cols; }
 
+    /**
+     * @brief Distância, em escalares, entre o início de linhas consecutivas.
+     *
+     * @return size_t O número de colunas da matriz mais o preenchimento de
+     * cada linha.
+     */
+    size_t stride() const { return m_stride; }
+
+    /**
+     * @brief Distância, em escalares, entre o início de linhas consecutivas
+     * de uma matriz com as dimensões dadas.
+     *
+     * @param cols Número de colunas.
+     * @param reserved Número de colunas reservadas.
+     * @return size_t O valor de `stride()` para essa matriz.
+     */
+    static size_t padded_stride(size_t cols, size_t reserved = 0) {
+        return padded(cols + reserved);
+    }
+
+    /**
+     * @brief Células da matriz, linha a linha, com `stride()` escalares entre
+     * o início de linhas consecutivas.
+     *
+     * @return F* Ponteiro para a célula (0, 0), alinhado a `ALIGNMENT` bytes.
+     */
+    scalar_type* data() { return m_cells; }
+
+    /**
+     * @brief Células da matriz, linha a linha, com `stride()` escalares entre
+     * o início de linhas consecutivas.
+     *
+     * @return const F* Ponteiro imutável para a célula (0, 0), alinhado a
+     * `ALIGNMENT` bytes.
+     */
+    const scalar_type* data() const { return m_cells; }
+
+    /**
+     * @brief Células de uma linha da matriz, sem verificar o índice.
+     *
+     * @param row Linha desejada.
+     *
+     * @return F* Ponteiro para a primeira célula da linha.
+     */
+    scalar_type* row_data(size_t row) { return m_cells + row * m_stride; }
+
+    /**
+     * @brief Células de uma linha da matriz, sem verificar o índice.
+     *
+     * @param row Linha desejada.
+     *
+     * @return const F* Ponteiro imutável para a primeira célula da linha.
+     */
+    const scalar_type* row_data(size_t row) const {
+        return m_cells + row * m_stride;
+    }
+
+    /**
+     * @brief Acessa uma célula da matriz sem verificar os índices. Para uso em
+     * laços cujos limites já foram validados.
+     *
+     * @param row Linha da célula desejada.
+     * @param col Coluna da célula desejada.
+     *
+     * @return F& Referência para a célula da matriz.
+     */
+    reference unchecked_at(size_t row, size_t col) {
+        return m_cells[col + row * m_stride];
+    }
+
+    /**
+     * @brief Acessa uma célula da matriz sem verificar os índices.
+     *
+     * @param row Linha da célula desejada.
+     * @param col Coluna da célula desejada.
+     *
+     * @return F Valor da célula na matriz.
+     */
+    const_reference unchecked_at(size_t row, size_t col) const {
+        return m_cells[col + row * m_stride];
+    }
+
     /**
      * @brief Lê uma célula da matriz.
      *
@@ -324,7 +625,7 @@ template <typename F> class matnxm {
         internal::validate("matrix cell out of bounds",
                            [&]() { return row < m_rows && col < m_cols; });
 
-        return m_cells[col + row * m_cols];
+        return m_cells[col + row * m_stride];
     }
 
     /**
@@ -339,7 +640,7 @@ template <typename F> class matnxm {
         internal::validate("matrix cell out of bounds",
                            [&]() { return row < m_rows && col < m_cols; });
 
-        return m_cells[col + row * m_cols];
+        return m_cells[col + row * m_stride];
     }
 
     /**
@@ -419,42 +720,33 @@ template <typename F> class matnxm {
     row_type operator[](size_t row) { return this->operator()(row, all); }
 
     /**
-     * @brief Soma de matrizes.
+     * @brief Acessa uma coluna reservada da matriz (vide o construtor com
+     * colunas reservadas).
      *
-     * @param other Outra matriz.
+     * @param k Índice da coluna reservada, a partir de 0.
      *
-     * @return mrow Matriz resultante da soma desta matriz com `other`.
+     * @return const_mcol Uma referência imutável para a coluna reservada.
      */
-    matnxm operator+(const matnxm& other) const {
-        internal::validate("cannot add matrices of different sizes", [&]() {
-            return other.rows() == rows() && other.cols() == cols();
-        });
+    const_column_type reserved_column(size_t k) const {
+        internal::validate("reserved column index out of bounds",
+                           [&]() { return cols() + k < stride(); });
 
-        matnxm result(*this);
-        for (size_t i = 0; i < rows(); i++) {
-            for (size_t j = 0; j < cols(); j++) {
-                result(i, j) += other(i, j);
-            }
-        }
-        return result;
+        return const_column_type(*this, cols() + k);
     }
 
     /**
-     * @brief Produto matriz-escalar.
+     * @brief Acessa uma coluna reservada da matriz (vide o construtor com
+     * colunas reservadas).
      *
-     * @param scalar Escalar.
+     * @param k Índice da coluna reservada, a partir de 0.
      *
-     * @return matnxm Matriz resultante do produto desta matriz com o escalar
-     * `scalar`.
+     * @return mcol Uma referência para a coluna reservada.
      */
-    matnxm operator*(scalar_type scalar) const {
-        matnxm result(*this);
-        for (size_t i = 0; i < rows(); i++) {
-            for (size_t j = 0; j < cols(); j++) {
-                result(i, j) *= scalar;
-            }
-        }
-        return result;
+    column_type reserved_column(size_t k) {
+        internal::validate("reserved column index out of bounds",
+                           [&]() { return cols() + k < stride(); });
+
+        return column_type(*this, cols() + k);
     }
 
     /**
@@ -470,11 +762,17 @@ template <typename F> class matnxm {
             "cannot multiply matrices of incompatible dimensions",
             [&]() { return cols() == other.rows(); });
 
+        // Acumula a_ik · (linha k de other) na linha i do resultado, de forma
+        // que o laço interno percorre linhas contíguas.
         matnxm result(rows(), other.cols());
         for (size_t i = 0; i < rows(); i++) {
-            for (size_t j = 0; j < other.cols(); j++) {
-                result(i, j) =
-                    this->operator()(i, all).to_vec() * other(all, j).to_vec();
+            const scalar_type* a = row_data(i);
+            scalar_type* r = result.row_data(i);
+            for (size_t k = 0; k < cols(); k++) {
+                const scalar_type* o = other.row_data(k);
+                for (size_t j = 0; j < other.cols(); j++) {
+                    r[j] += a[k] * o[j];
+                }
             }
         }
         return result;
@@ -489,7 +787,21 @@ template <typename F> class matnxm {
      * o vetor-coluna `other`.
      */
     vecn<scalar_type> operator*(const vecn<scalar_type>& other) const {
-        return ((*this) * matnxm::column(other))(all, 0).to_vec();
+        internal::validate(
+            "cannot multiply matrix and vector of incompatible dimensions",
+            [&]() { return cols() == other.size(); });
+
+        vecn<scalar_type> result(rows());
+        const scalar_type* x = other.data();
+        for (size_t i = 0; i < rows(); i++) {
+            const scalar_type* a = row_data(i);
+            scalar_type dot = 0;
+            for (size_t j = 0; j < cols(); j++) {
+                dot += a[j] * x[j];
+            }
+            result.unchecked_at(i) = dot;
+        }
+        return result;
     }
 
     /**
@@ -500,9 +812,8 @@ template <typename F> class matnxm {
     matnxm T() const {
         matnxm result(cols(), rows());
         for (size_t j = 0; j < cols(); j++) {
-            for (size_t i = 0; i < rows(); i++) {
-                result(j, i) = this->operator()(i, j);
-            }
+            std::copy((*this)(all, j).begin(), (*this)(all, j).end(),
+                      result.row_data(j));
         }
         return result;
     }
@@ -515,10 +826,9 @@ template <typename F> class matnxm {
      */
     bool zero() const {
         for (size_t i = 0; i < rows(); i++) {
-            for (size_t j = 0; j < cols(); j++) {
-                if (this->operator()(i, j) != 0) {
-                    return false;
-                }
+            if (!std::all_of(row_data(i), row_data(i) + cols(),
+                             [](scalar_type x) { return x == 0; })) {
+                return false;
             }
         }
         return true;
@@ -560,10 +870,57 @@ template <typename F> class matnxm {
     static matnxm identity(size_t size) {
         matnxm result(size, size);
         for (size_t i = 0; i < size; i++) {
-            result(i, i) = 1;
+            result.unchecked_at(i, i) = 1;
         }
         return result;
     }
+
+  private:
+    /**
+     * @brief Número de escalares de uma linha com `width` colunas, preenchida
+     * até um múltiplo de `VECTOR_BYTES` bytes.
+     */
+    static size_t padded(size_t width) {
+        size_t lanes = std::max<size_t>(1, VECTOR_BYTES / sizeof(F));
+        return (width + lanes - 1) / lanes * lanes;
+    }
+
+    /**
+     * @brief Aloca células zeradas para `rows` linhas de `stride` escalares,
+     * a partir de um endereço alinhado a `ALIGNMENT` bytes.
+     */
+    void allocate(size_t rows, size_t cols, size_t stride) {
+        size_t cells = rows * stride;
+        size_t slack = (ALIGNMENT + sizeof(F) - 1) / sizeof(F);
+        m_storage = std::make_unique<F[]>(cells + slack);
+
+        void* first = m_storage.get();
+        size_t space = (cells + slack) * sizeof(F);
+        m_cells = static_cast<F*>(
+            std::align(ALIGNMENT, cells * sizeof(F), first, space));
+        m_rows = rows;
+        m_cols = cols;
+        m_stride = stride;
+    }
+
+    /**
+     * @brief Avalia uma expressão matricial, de mesmo tamanho, nesta matriz.
+     */
+    template <typename E> void assign(const E& e) {
+        for (size_t i = 0; i < m_rows; i++) {
+            scalar_type* row = row_data(i);
+            for (size_t j = 0; j < m_cols; j++) {
+                row[j] = e.unchecked_at(i, j);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Matrizes são guardadas por referência nas expressões.
+ */
+template <typename F> struct expr_operand<matnxm<F>> {
+    using type = const matnxm<F>&;
 };
 }; // namespace linalg
 
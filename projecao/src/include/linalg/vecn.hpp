@@ -7,20 +7,27 @@
 
 #include <internal.hpp>
 
+#include "expr.hpp"
+
 namespace linalg {
 /**
  * @brief Classe para vetores sobre um corpo F.
  *
+ * As operações aritméticas sobre vetores (vide `vec_expr`) são avaliadas
+ * apenas quando atribuídas a um vetor, sem criar vetores intermediários.
+ *
  * @tparam F Tipo de escalar.
  */
-template <typename F> class vecn {
+template <typename F> class vecn : public vec_expr<vecn<F>> {
   private:
-    size_t m_size;
+    size_t m_size = 0;
     std::unique_ptr<F[]> m_coords;
 
   public:
     using scalar_type = F;
     using reference = scalar_type&;
+    using iterator = scalar_type*;
+    using const_iterator = const scalar_type*;
 
     vecn() = default;
 
@@ -43,6 +50,35 @@ template <typename F> class vecn {
         std::move(coords.begin(), coords.end(), m_coords.get());
     }
 
+    /**
+     * @brief Constrói um vetor avaliando uma expressão vetorial.
+     *
+     * @param e Expressão.
+     */
+    template <typename E> vecn(const vec_expr<E>& e) {
+        m_size = e.self().size();
+        m_coords = std::make_unique<F[]>(m_size);
+        assign(e.self());
+    }
+
+    /**
+     * @brief Avalia uma expressão vetorial neste vetor. A expressão pode
+     * conter o próprio vetor, já que cada coordenada depende apenas das
+     * coordenadas de mesmo índice dos operandos.
+     *
+     * @param e Expressão.
+     *
+     * @return vecn& Referência para este vetor.
+     */
+    template <typename E> vecn& operator=(const vec_expr<E>& e) {
+        if (e.self().size() != m_size) {
+            vecn result(e);
+            return *this = std::move(result);
+        }
+        assign(e.self());
+        return *this;
+    }
+
     vecn& operator=(std::initializer_list<F>&& coords) {
         std::move(coords.begin(), coords.end(), m_coords.get());
         m_size = coords.size();
@@ -67,8 +103,8 @@ template <typename F> class vecn {
      */
     vecn(size_t size, scalar_type value) {
         m_size = size;
-        m_coords = new scalar_type[size];
-        std::fill(m_coords, m_coords + size, value);
+        m_coords = std::make_unique<F[]>(size);
+        std::fill(begin(), end(), value);
     }
 
     /**
@@ -79,86 +115,42 @@ template <typename F> class vecn {
     size_t size() const { return m_size; }
 
     /**
-     * @brief Soma de vetores.
-     *
-     * @param other Outro vetor.
+     * @brief Coordenadas do vetor, em posições contíguas de memória.
      *
-     * @return vecn Vetor resultante da soma deste vetor com `other`.
+     * @return F* Ponteiro para a primeira coordenada.
      */
-    vecn operator+(const vecn& other) const {
-        internal::validate("cannot add vectors of different sizes",
-                           [&]() { return other.size() == size(); });
-
-        vecn result(*this);
-        for (size_t i = 0; i < m_size; i++) {
-            result[i] += other[i];
-        }
-        return result;
-    }
+    scalar_type* data() { return m_coords.get(); }
 
     /**
-     * @brief Inverso aditivo do vetor.
+     * @brief Coordenadas do vetor, em posições contíguas de memória.
      *
-     * @return vecn O inverso aditivo do vetor original.
+     * @return const F* Ponteiro imutável para a primeira coordenada.
      */
-    vecn operator-() const {
-        vecn result(*this);
-        for (size_t i = 0; i < m_size; i++) {
-            result[i] *= -1;
-        }
-        return result;
-    }
+    const scalar_type* data() const { return m_coords.get(); }
 
-    /**
-     * @brief Inverso aditivo do vetor.
-     *
-     * @return vecn O inverso aditivo do vetor original.
-     */
-    vecn operator-(const vecn& other) const {
-        internal::validate("cannot subtract vectors of different sizes",
-                           [&]() { return other.size() == size(); });
-
-        vecn result(*this);
-        for (size_t i = 0; i < m_size; i++) {
-            result[i] -= other[i];
-        }
-        return result;
-    }
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
 
     /**
-     * @brief Produto vetor-escalar.
+     * @brief Acessa uma coordenada do vetor sem verificar o índice. Para uso
+     * em laços cujos limites já foram validados.
      *
-     * @param scalar Escalar.
+     * @param index Índice da coordenada.
      *
-     * @return vecn Vetor resultante do produto deste vetor com o escalar
-     * `scalar`.
+     * @return F& Referência para a coordenada do vetor.
      */
-    vecn operator*(scalar_type scalar) const {
-        vecn result(*this);
-        for (size_t i = 0; i < m_size; i++) {
-            result[i] *= scalar;
-        }
-        return result;
-    }
+    reference unchecked_at(size_t index) { return m_coords[index]; }
 
     /**
-     * @brief Produto interno de vetores.
+     * @brief Acessa uma coordenada do vetor sem verificar o índice.
      *
-     * @param other Outro vetor.
+     * @param index Índice da coordenada.
      *
-     * @return F Escalar resultante do produto interno deste vetor e `other`.
+     * @return F Valor da coordenada do vetor.
      */
-    scalar_type operator*(const vecn& other) const {
-        internal::validate(
-            "cannot take dot product of vectors of different sizes",
-            [&]() { return other.size() == size(); });
-
-        F result = 0;
-        for (size_t i = 0; i < m_size; i++) {
-            result += this->operator[](i) * other[i];
-        }
-        return result;
-    }
+    scalar_type unchecked_at(size_t index) const { return m_coords[index]; }
 
     /**
      * @brief Acessa uma coordenada do vetor.
@@ -195,14 +187,28 @@ template <typename F> class vecn {
      * @return false caso contrário.
      */
     bool zero() const {
-        for (size_t i = 0; i < size(); i++) {
-            if (this->operator[](i) != 0) {
-                return false;
-            }
+        return std::all_of(begin(), end(),
+                           [](scalar_type x) { return x == 0; });
+    }
+
+  private:
+    /**
+     * @brief Avalia uma expressão vetorial, de mesmo tamanho, neste vetor.
+     */
+    template <typename E> void assign(const E& e) {
+        scalar_type* coords = m_coords.get();
+        for (size_t i = 0; i < m_size; i++) {
+            coords[i] = e.unchecked_at(i);
         }
-        return true;
     }
 };
+
+/**
+ * @brief Vetores são guardados por referência nas expressões.
+ */
+template <typename F> struct expr_operand<vecn<F>> {
+    using type = const vecn<F>&;
+};
 }; // namespace linalg
 
 #endif // __LINALG_VECN__
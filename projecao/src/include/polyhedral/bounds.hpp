@@ -0,0 +1,334 @@
+#ifndef __POLYHEDRAL_BOUNDS__
+#define __POLYHEDRAL_BOUNDS__
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "polyhedron.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Caixa l <= x <= u que contém um poliedro, com limites possivelmente
+ * ausentes (infinitos).
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> struct box {
+    vecn<F> lower;
+    vecn<F> upper;
+    std::vector<char> has_lower;
+    std::vector<char> has_upper;
+
+    // Se verdadeiro, os limites provam que o poliedro é vazio.
+    bool infeasible = false;
+
+    /**
+     * @brief Constrói a caixa R^dimensions (sem limites).
+     *
+     * @param dimensions Número de dimensões.
+     */
+    explicit box(size_t dimensions)
+        : lower(dimensions), upper(dimensions), has_lower(dimensions),
+          has_upper(dimensions) {}
+
+    /**
+     * @brief Número de dimensões da caixa.
+     */
+    size_t dimensions() const { return lower.size(); }
+};
+
+namespace internal_bounds {
+/**
+ * @brief Tolerância relativa das somas de intervalos.
+ */
+template <typename F> constexpr F tolerance() {
+    return std::numeric_limits<F>::epsilon() * 1024;
+}
+
+// Melhoria relativa mínima para que um limite seja atualizado, o que garante
+// que a propagação termina.
+template <typename F> constexpr F min_improvement() {
+    return F(1) / (1 << 20);
+}
+
+// Número máximo de passadas sobre as linhas.
+static constexpr size_t MAX_ROUNDS = 64;
+
+template <typename F> F abs(F x) { return x < 0 ? -x : x; }
+
+/**
+ * @brief Atividade mínima de uma linha a · x sobre uma caixa: a soma dos
+ * termos finitos, a soma dos seus módulos, o número de termos infinitos e o
+ * índice de um deles.
+ */
+template <typename F> struct activity {
+    F finite = 0;
+    F scale = 0;
+    size_t infinite = 0;
+    size_t unbounded = 0;
+};
+
+template <typename F>
+activity<F> min_activity(const F* a, size_t n, const box<F>& B) {
+    activity<F> result;
+    for (size_t j = 0; j < n; j++) {
+        if (a[j] == 0) {
+            continue;
+        }
+        bool bounded = a[j] > 0 ? B.has_lower[j] : B.has_upper[j];
+        if (!bounded) {
+            result.infinite++;
+            result.unbounded = j;
+            continue;
+        }
+        F term = a[j] * (a[j] > 0 ? B.lower.unchecked_at(j)
+                                  : B.upper.unchecked_at(j));
+        result.finite += term;
+        result.scale += abs(term);
+    }
+    return result;
+}
+
+/**
+ * @brief Atualiza um limite de x_j, se o novo valor for suficientemente
+ * melhor.
+ *
+ * @return true se o limite foi atualizado.
+ */
+template <typename F>
+bool tighten(box<F>& B, size_t j, bool upper, F value) {
+    auto& bound = upper ? B.upper.unchecked_at(j) : B.lower.unchecked_at(j);
+    auto& has = upper ? B.has_upper[j] : B.has_lower[j];
+
+    F margin = min_improvement<F>() * std::max<F>(1, abs(bound));
+    if (has && (upper ? value >= bound - margin : value <= bound + margin)) {
+        return false;
+    }
+    bound = value;
+    has = 1;
+
+    if (B.has_lower[j] && B.has_upper[j] &&
+        B.lower.unchecked_at(j) > B.upper.unchecked_at(j)) {
+        B.infeasible = true;
+    }
+    return true;
+}
+}; // namespace internal_bounds
+
+/**
+ * @brief Propagação de limites (FBBT): calcula uma caixa que contém o
+ * poliedro, ou prova que ele é vazio.
+ *
+ * Para cada linha a · x <= β e cada j com a_j ≠ 0, o limite inferior da
+ * soma dos demais termos sobre a caixa atual dá um limite para a_j x_j:
+ *  a_j x_j <= β - Σ_{k ≠ j} min(a_k x_k).
+ * As linhas são percorridas até que nenhum limite melhore (ou até um número
+ * máximo de passadas). Se a soma mínima de uma linha excede β, ou se algum
+ * limite inferior excede o superior, o poliedro é vazio.
+ *
+ * Os limites são afastados por uma tolerância relativa aos termos somados,
+ * de forma que a caixa contém o poliedro apesar dos erros de arredondamento.
+ * Para escalares que não são de ponto flutuante, as divisões seriam
+ * truncadas, e a caixa retornada não tem limites.
+ *
+ * @param P Poliedro.
+ * @param resources Orçamento de recursos (apenas o tempo é limitado).
+ * @return box<F> Uma caixa que contém P(A, b).
+ */
+template <typename F>
+box<F> propagate_bounds(const polyhedron<F>& P, const budget& resources) {
+    using namespace internal_bounds;
+
+    const auto& A = P.A();
+    const auto& b = P.b();
+    size_t n = P.dimensions();
+
+    box<F> B(n);
+    if (!std::is_floating_point<F>::value) {
+        return B;
+    }
+
+    bool changed = true;
+    for (size_t round = 0; round < MAX_ROUNDS && changed; round++) {
+        resources.check_time();
+        changed = false;
+
+        for (size_t i = 0; i < A.rows(); i++) {
+            const F* a = A.row_data(i);
+            F rhs = b.unchecked_at(i);
+            auto act = min_activity(a, n, B);
+            F slack = tolerance<F>() * (act.scale + abs(rhs));
+
+            if (act.infinite == 0 && act.finite > rhs + slack) {
+                B.infeasible = true;
+                return B;
+            }
+            if (act.infinite > 1) {
+                continue;
+            }
+
+            // Com um único termo infinito, somente a sua variável recebe um
+            // limite.
+            size_t first = act.infinite == 1 ? act.unbounded : 0;
+            size_t last = act.infinite == 1 ? act.unbounded + 1 : n;
+            for (size_t j = first; j < last; j++) {
+                if (a[j] == 0) {
+                    continue;
+                }
+
+                F rest = act.finite;
+                if (act.infinite == 0) {
+                    rest -= a[j] * (a[j] > 0 ? B.lower.unchecked_at(j)
+                                             : B.upper.unchecked_at(j));
+                }
+                F value = (rhs - rest + slack) / a[j];
+                changed |= tighten(B, j, a[j] > 0, value);
+                if (B.infeasible) {
+                    return B;
+                }
+            }
+        }
+    }
+    return B;
+}
+
+/**
+ * @brief Substitui as linhas de um poliedro que são redundantes sobre uma
+ * caixa que o contém pelos limites da caixa.
+ *
+ * Uma linha com mais de uma variável é redundante sobre a caixa se a sua
+ * atividade máxima na caixa não excede o lado direito. As linhas com uma só
+ * variável já são limites e são sempre mantidas; os limites da caixa mais
+ * justos do que elas são adicionados como linhas x_j <= u_j e -x_j <= -l_j,
+ * somente para as variáveis que aparecem nas linhas mantidas.
+ *
+ * Os limites de que depende a redundância de uma linha removida são sempre
+ * adicionados (a menos que uma linha com uma só variável já seja tão justa
+ * quanto eles), de forma que todo ponto do resultado satisfaz as linhas
+ * removidas e o resultado é vazio sse o poliedro é vazio. Os demais só são
+ * adicionados se melhoram o limite da linha correspondente por uma margem.
+ *
+ * @param P Poliedro.
+ * @param B Caixa que contém P, calculada por `propagate_bounds`.
+ * @return polyhedron<F> O poliedro com as linhas redundantes substituídas.
+ */
+template <typename F>
+polyhedron<F> apply_bounds(const polyhedron<F>& P, const box<F>& B) {
+    using namespace internal_bounds;
+
+    const auto& A = P.A();
+    const auto& b = P.b();
+    size_t n = P.dimensions();
+
+    // Limites dados pelas linhas com uma só variável.
+    box<F> single(n);
+
+    std::vector<size_t> kept;
+    std::vector<char> used(n);
+
+    // Limites da caixa usados para provar a redundância das linhas removidas.
+    std::vector<char> need_upper(n), need_lower(n);
+    for (size_t i = 0; i < A.rows(); i++) {
+        const F* a = A.row_data(i);
+        F rhs = b.unchecked_at(i);
+
+        // Atividade máxima na caixa: a atividade mínima de -a.
+        F max = 0, scale = 0;
+        size_t variables = 0, last = 0;
+        bool bounded = true;
+        for (size_t j = 0; j < n; j++) {
+            if (a[j] == 0) {
+                continue;
+            }
+            variables++;
+            last = j;
+            bounded = bounded && (a[j] > 0 ? B.has_upper[j] : B.has_lower[j]);
+            if (bounded) {
+                F term = a[j] * (a[j] > 0 ? B.upper.unchecked_at(j)
+                                          : B.lower.unchecked_at(j));
+                max += term;
+                scale += abs(term);
+            }
+        }
+
+        if (variables == 1) {
+            F value = rhs / a[last];
+            auto& bound = a[last] > 0 ? single.upper.unchecked_at(last)
+                                      : single.lower.unchecked_at(last);
+            auto& has = a[last] > 0 ? single.has_upper[last]
+                                    : single.has_lower[last];
+            if (!has || (a[last] > 0 ? value < bound : value > bound)) {
+                bound = value;
+                has = 1;
+            }
+        } else if (bounded &&
+                   max + tolerance<F>() * (scale + abs(rhs)) <= rhs) {
+            for (size_t j = 0; j < n; j++) {
+                need_upper[j] |= a[j] > 0;
+                need_lower[j] |= a[j] < 0;
+            }
+            continue;
+        }
+
+        kept.push_back(i);
+        for (size_t j = 0; j < n; j++) {
+            used[j] |= a[j] != 0;
+        }
+    }
+
+    // Um limite da caixa é adicionado se for mais justo do que o da linha
+    // com uma só variável correspondente, se houver: por qualquer diferença,
+    // se alguma linha removida depende dele, e por uma margem caso contrário.
+    auto tighter = [&](size_t j, bool upper) {
+        if (!used[j] || !(upper ? B.has_upper[j] : B.has_lower[j])) {
+            return false;
+        }
+        if (!(upper ? single.has_upper[j] : single.has_lower[j])) {
+            return true;
+        }
+        F bound = upper ? B.upper.unchecked_at(j) : B.lower.unchecked_at(j);
+        F other = upper ? single.upper.unchecked_at(j)
+                        : single.lower.unchecked_at(j);
+        F margin = (upper ? need_upper[j] : need_lower[j])
+                       ? F(0)
+                       : min_improvement<F>() * std::max<F>(1, abs(other));
+        return upper ? bound < other - margin : bound > other + margin;
+    };
+
+    std::vector<char> add_upper(n), add_lower(n);
+    size_t bounds = 0;
+    for (size_t j = 0; j < n; j++) {
+        add_upper[j] = tighter(j, true);
+        add_lower[j] = tighter(j, false);
+        bounds += add_upper[j] + add_lower[j];
+    }
+
+    matnxm<F> D(kept.size() + bounds, n);
+    vecn<F> d(kept.size() + bounds);
+    size_t r = 0;
+    for (size_t i : kept) {
+        std::copy_n(A.row_data(i), n, D.row_data(r));
+        d.unchecked_at(r++) = b.unchecked_at(i);
+    }
+    for (size_t j = 0; j < n; j++) {
+        if (add_upper[j]) {
+            D.unchecked_at(r, j) = 1;
+            d.unchecked_at(r++) = B.upper.unchecked_at(j);
+        }
+        if (add_lower[j]) {
+            D.unchecked_at(r, j) = -1;
+            d.unchecked_at(r++) = F(0) - B.lower.unchecked_at(j);
+        }
+    }
+    return {std::move(D), std::move(d)};
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_BOUNDS__
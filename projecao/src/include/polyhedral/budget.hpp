@@ -0,0 +1,225 @@
+#ifndef __POLYHEDRAL_BUDGET__
+#define __POLYHEDRAL_BUDGET__
+
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <linalg.hpp>
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Limites de recursos para eliminações. Um limite igual a zero indica
+ * que o recurso correspondente não é limitado.
+ */
+struct resource_limits {
+    // Número máximo de linhas geradas em um passo de eliminação.
+    size_t max_rows = 0;
+
+    // Número máximo de bytes ocupados pelas linhas de entrada e de saída de
+    // um passo de eliminação (vide `budget::matrix_bytes`). O limite vale
+    // para cada passo, e não para a soma dos passos.
+    size_t max_step_bytes = 0;
+
+    // Tempo máximo desde a criação do orçamento.
+    std::chrono::steady_clock::duration timeout =
+        std::chrono::steady_clock::duration::zero();
+};
+
+/**
+ * @brief Classe para um erro de orçamento de recursos excedido.
+ */
+class budget_exceeded : public std::runtime_error {
+  private:
+    size_t m_step;
+    size_t m_variable;
+
+  public:
+    budget_exceeded(size_t step, size_t variable, const std::string& reason)
+        : std::runtime_error(describe(step, variable, reason)), m_step(step),
+          m_variable(variable) {}
+
+    /**
+     * @brief Passo de eliminação no qual o limite foi excedido (a partir de
+     * 1).
+     *
+     * @return size_t O número do passo.
+     */
+    size_t step() const noexcept { return m_step; }
+
+    /**
+     * @brief Variável sendo eliminada quando o limite foi excedido.
+     *
+     * @return size_t O índice da variável (a partir de 0), ou
+     * `budget::no_variable` se o passo era uma projeção em direção arbitrária.
+     */
+    size_t variable() const noexcept { return m_variable; }
+
+  private:
+    static std::string describe(size_t step, size_t variable,
+                                const std::string& reason);
+};
+
+/**
+ * @brief Orçamento de recursos de uma sequência de eliminações.
+ *
+ * O orçamento é verificado antes de cada alocação, com base no tamanho
+ * |Z| + |N| × |P| do resultado, e periodicamente durante a geração de linhas.
+ * Quando algum limite é excedido, é lançado um `budget_exceeded` que indica o
+ * passo e a variável responsáveis.
+ */
+class budget {
+  private:
+    resource_limits m_limits;
+    std::chrono::steady_clock::time_point m_start;
+    size_t m_step = 0;
+    size_t m_variable;
+
+  public:
+    static constexpr size_t no_variable = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief Constrói um orçamento sem limites.
+     */
+    budget() : budget(resource_limits()) {}
+
+    /**
+     * @brief Constrói um orçamento com os limites dados. O tempo é contado a
+     * partir da construção.
+     *
+     * @param limits Limites do orçamento.
+     */
+    explicit budget(const resource_limits& limits)
+        : m_limits(limits), m_start(std::chrono::steady_clock::now()),
+          m_variable(no_variable) {}
+
+    /**
+     * @brief Limites do orçamento.
+     *
+     * @return const resource_limits& Uma referência imutável para os
+     * limites.
+     */
+    const resource_limits& limits() const { return m_limits; }
+
+    /**
+     * @brief Inicia um novo passo de eliminação.
+     *
+     * @param variable Índice da variável eliminada no passo, ou `no_variable`
+     * para uma projeção em direção arbitrária.
+     */
+    void begin_step(size_t variable) {
+        m_step++;
+        m_variable = variable;
+        check_time();
+    }
+
+    /**
+     * @brief Reinicia a contagem de passos, mantendo o tempo já decorrido.
+     */
+    void reset_steps() {
+        m_step = 0;
+        m_variable = no_variable;
+    }
+
+    /**
+     * @brief Verifica se um passo pode alocar o resultado.
+     *
+     * @param rows Número de linhas do resultado.
+     * @param bytes Número de bytes das entradas e do resultado do passo.
+     */
+    void check_allocation(size_t rows, size_t bytes) const {
+        if (m_limits.max_rows != 0 && rows > m_limits.max_rows) {
+            fail(std::to_string(rows) + " rows > " +
+                 std::to_string(m_limits.max_rows) + " allowed");
+        }
+        if (m_limits.max_step_bytes != 0 && bytes > m_limits.max_step_bytes) {
+            fail(std::to_string(bytes) + " bytes > " +
+                 std::to_string(m_limits.max_step_bytes) +
+                 " allowed per step");
+        }
+        check_time();
+    }
+
+    /**
+     * @brief Verifica se o tempo limite foi atingido.
+     */
+    void check_time() const {
+        if (m_limits.timeout == std::chrono::steady_clock::duration::zero()) {
+            return;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        if (elapsed > m_limits.timeout) {
+            std::chrono::duration<double> seconds = m_limits.timeout;
+            fail("timeout of " + std::to_string(seconds.count()) +
+                 " s reached");
+        }
+    }
+
+    /**
+     * @brief Calcula o número de bytes de `rows` linhas com `cols` escalares de
+     * tamanho `size`, saturando em caso de overflow.
+     */
+    static size_t bytes(size_t rows, size_t cols, size_t size) {
+        const size_t max = std::numeric_limits<size_t>::max();
+        size_t row = cols * size;
+        if (row != 0 && rows > max / row) {
+            return max;
+        }
+        return rows * row;
+    }
+
+    /**
+     * @brief Calcula o número de bytes das linhas de uma `matnxm<F>`, com o
+     * preenchimento de cada linha (`stride() × rows × sizeof(F)`).
+     *
+     * Este é o modelo de memória de todos os passos: cada linha conta com o
+     * tamanho que ela ocupa no armazenamento, isto é, o passo entre linhas
+     * de uma `matnxm` ou a largura das linhas de um buffer contíguo.
+     *
+     * @param rows Número de linhas.
+     * @param cols Número de colunas.
+     * @param reserved Número de colunas reservadas.
+     */
+    template <typename F>
+    static size_t matrix_bytes(size_t rows, size_t cols, size_t reserved = 0) {
+        return bytes(rows, matnxm<F>::padded_stride(cols, reserved),
+                     sizeof(F));
+    }
+
+    /**
+     * @brief Calcula o número de bytes das linhas aumentadas [A | b] de um
+     * poliedro com `rows` linhas e `cols` dimensões.
+     */
+    template <typename F>
+    static size_t polyhedron_bytes(size_t rows, size_t cols) {
+        return matrix_bytes<F>(rows, cols, 1);
+    }
+
+    /**
+     * @brief Soma dois números de bytes, saturando em caso de overflow.
+     */
+    static size_t sum(size_t a, size_t b) {
+        const size_t max = std::numeric_limits<size_t>::max();
+        return a > max - b ? max : a + b;
+    }
+
+  private:
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw budget_exceeded(m_step, m_variable, reason);
+    }
+};
+
+inline std::string budget_exceeded::describe(size_t step, size_t variable,
+                                             const std::string& reason) {
+    std::string where = variable == budget::no_variable
+                            ? "projecting on direction"
+                            : "eliminating x" + std::to_string(variable + 1);
+    return "budget exceeded at step " + std::to_string(step) + " (" + where +
+           "): " + reason;
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_BUDGET__
@@ -0,0 +1,132 @@
+#ifndef __POLYHEDRAL_COLUMN_INDEX__
+#define __POLYHEDRAL_COLUMN_INDEX__
+
+#include <vector>
+
+#include <linalg.hpp>
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Índice de sinais por coluna de uma matriz: as linhas com coeficiente
+ * negativo e as com coeficiente positivo em cada coluna, em ordem crescente.
+ *
+ * Com o índice, o número de linhas geradas pela eliminação de qualquer
+ * variável é calculado em O(1), sem ler a coluna, o que barateia a escolha
+ * da próxima variável em `polyhedron::eliminate`, e a partição (N, Z, P) de
+ * uma coluna é lida diretamente, em tempo proporcional aos coeficientes não
+ * nulos da coluna e a |Z|. O índice do resultado de um passo é construído a
+ * partir das linhas geradas.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class column_index {
+  private:
+    size_t m_rows = 0;
+    std::vector<std::vector<size_t>> m_negative;
+    std::vector<std::vector<size_t>> m_positive;
+
+  public:
+    column_index() = default;
+
+    /**
+     * @brief Constrói o índice de uma matriz.
+     *
+     * @param A Matriz.
+     */
+    explicit column_index(const matnxm<F>& A) {
+        reset(A.cols());
+        for (size_t i = 0; i < A.rows(); i++) {
+            append(A.row_data(i));
+        }
+    }
+
+    /**
+     * @brief Esvazia o índice.
+     *
+     * @param cols Número de colunas.
+     */
+    void reset(size_t cols) {
+        m_rows = 0;
+        m_negative.assign(cols, {});
+        m_positive.assign(cols, {});
+    }
+
+    /**
+     * @brief Número de linhas indexadas.
+     */
+    size_t rows() const { return m_rows; }
+
+    /**
+     * @brief Número de colunas.
+     */
+    size_t cols() const { return m_negative.size(); }
+
+    /**
+     * @brief Adiciona uma linha ao índice.
+     *
+     * @param row Coeficientes da linha, com `cols()` escalares.
+     */
+    void append(const F* row) {
+        for (size_t j = 0; j < cols(); j++) {
+            if (row[j] < 0) {
+                m_negative[j].push_back(m_rows);
+            } else if (row[j] > 0) {
+                m_positive[j].push_back(m_rows);
+            }
+        }
+        m_rows++;
+    }
+
+    /**
+     * @brief Linhas com coeficiente negativo na coluna j.
+     */
+    const std::vector<size_t>& negative(size_t j) const {
+        return m_negative[j];
+    }
+
+    /**
+     * @brief Linhas com coeficiente positivo na coluna j.
+     */
+    const std::vector<size_t>& positive(size_t j) const {
+        return m_positive[j];
+    }
+
+    /**
+     * @brief Calcula as linhas com coeficiente nulo na coluna j, o complemento
+     * de `negative(j)` e `positive(j)`, sem ler a coluna.
+     *
+     * @param j Índice da coluna.
+     * @param out Referência de saída para as linhas, em ordem crescente.
+     */
+    void zero(size_t j, std::vector<size_t>& out) const {
+        const auto& N = m_negative[j];
+        const auto& P = m_positive[j];
+        out.clear();
+        out.reserve(m_rows - N.size() - P.size());
+
+        size_t s = 0, t = 0;
+        for (size_t i = 0; i < m_rows; i++) {
+            if (s < N.size() && N[s] == i) {
+                s++;
+            } else if (t < P.size() && P[t] == i) {
+                t++;
+            } else {
+                out.push_back(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Número de linhas geradas pela eliminação da coluna j,
+     * |Z| + |N| × |P|.
+     */
+    size_t elimination_rows(size_t j) const {
+        size_t N = m_negative[j].size(), P = m_positive[j].size();
+        return (m_rows - N - P) + N * P;
+    }
+};
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_COLUMN_INDEX__
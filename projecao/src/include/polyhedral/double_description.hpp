@@ -0,0 +1,749 @@
+#ifndef __POLYHEDRAL_DOUBLE_DESCRIPTION__
+#define __POLYHEDRAL_DOUBLE_DESCRIPTION__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "polyhedron.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Representação de um poliedro por geradores (representação V):
+ * P = conv(V) + cone(R) + lin(L), em que V, R e L são as linhas das matrizes
+ * `vertices`, `rays` e `lines`.
+ *
+ * Um poliedro vazio não tem vértices.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> struct generators {
+    matnxm<F> vertices;
+    matnxm<F> rays;
+    matnxm<F> lines;
+
+    /**
+     * @brief Número de dimensões do espaço vetorial no qual o poliedro existe.
+     */
+    size_t dimensions() const { return vertices.cols(); }
+
+    /**
+     * @brief Determina se o poliedro gerado é vazio.
+     */
+    bool empty() const { return vertices.rows() == 0; }
+};
+
+/**
+ * @brief Método da dupla descrição (Motzkin et al.): calcula os raios
+ * extremos e uma base do espaço de linearidade do cone
+ * C = {y : h_k · y <= 0 para todo k}, adicionando uma restrição h_k de cada
+ * vez.
+ *
+ * Cada raio guarda o conjunto das restrições justas nele (h_k · r = 0). Ao
+ * adicionar uma restrição, os raios que a violam são descartados, e cada par
+ * adjacente de um raio que a satisfaz estritamente e um que a viola gera um
+ * novo raio sobre o hiperplano da restrição. Dois raios são adjacentes sse
+ * nenhum outro raio é justo em todas as restrições justas em ambos (teste
+ * combinatório), o que dispensa o cálculo de postos.
+ *
+ * Em escalares de ponto flutuante, um produto interno é considerado nulo se
+ * for pequeno em relação à soma dos módulos das suas parcelas, e cada raio
+ * novo é normalizado para ter coordenada máxima 1 em módulo.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class double_description {
+  public:
+    using scalar_type = F;
+
+  private:
+    using word = std::uint64_t;
+    static constexpr size_t WORD_BITS = 64;
+
+    size_t m_dimension;
+    size_t m_capacity;
+    size_t m_words;
+    size_t m_added = 0;
+
+    matnxm<scalar_type> m_lines;
+    matnxm<scalar_type> m_rays;
+
+    // Restrições justas em cada raio, com `m_words` palavras por raio.
+    std::vector<word> m_zeros;
+
+    // Operações feitas (produtos de escalares e operações sobre palavras) e
+    // limite de operações (0 se ilimitado).
+    size_t m_work = 0;
+    size_t m_work_limit;
+
+  public:
+    /**
+     * @brief Constrói o cone inicial R^dimension (sem raios, com a base
+     * canônica como espaço de linearidade).
+     *
+     * @param dimension Número de dimensões do cone.
+     * @param constraints Número máximo de restrições.
+     * @param work_limit Número máximo de operações (0 se ilimitado).
+     */
+    double_description(size_t dimension, size_t constraints,
+                       size_t work_limit = 0)
+        : m_dimension(dimension), m_capacity(constraints),
+          m_words((constraints + WORD_BITS - 1) / WORD_BITS),
+          m_lines(matnxm<scalar_type>::identity(dimension)),
+          m_rays(0, dimension), m_work_limit(work_limit) {}
+
+    /**
+     * @brief Raios extremos do cone.
+     */
+    const matnxm<scalar_type>& rays() const { return m_rays; }
+
+    /**
+     * @brief Base do espaço de linearidade do cone.
+     */
+    const matnxm<scalar_type>& lines() const { return m_lines; }
+
+    /**
+     * @brief Número de operações feitas até agora.
+     */
+    size_t work() const { return m_work; }
+
+    /**
+     * @brief Adiciona uma restrição h · y <= 0 ao cone.
+     *
+     * @param h Coeficientes da restrição, com `dimension` escalares.
+     * @param resources Orçamento de recursos.
+     * @return false se o limite de operações foi excedido; nesse caso, o cone
+     * não deve mais ser usado.
+     */
+    bool add(const scalar_type* h, const budget& resources) {
+        internal::validate("too many constraints for double description",
+                           [&]() { return m_added < m_capacity; });
+
+        size_t k = m_added++;
+        size_t D = m_dimension;
+
+        // Se alguma linha do espaço de linearidade não é ortogonal a h, a
+        // restrição apenas reduz o espaço de linearidade.
+        std::vector<scalar_type> line_dots(m_lines.rows());
+        size_t pivot = m_lines.rows();
+        for (size_t i = 0; i < m_lines.rows(); i++) {
+            line_dots[i] = dot(h, m_lines.row_data(i));
+            if (pivot == m_lines.rows() && line_dots[i] != 0) {
+                pivot = i;
+            }
+        }
+        m_work += m_lines.rows() * D;
+        if (pivot < m_lines.rows()) {
+            absorb_line(k, pivot, line_dots, h);
+            return within_limit();
+        }
+
+        // Particiona os raios pelo sinal do produto interno com h.
+        std::vector<scalar_type> dots(m_rays.rows());
+        std::vector<size_t> negative, zero, positive;
+        for (size_t r = 0; r < m_rays.rows(); r++) {
+            dots[r] = dot(h, m_rays.row_data(r));
+            if (dots[r] < 0) {
+                negative.push_back(r);
+            } else if (dots[r] > 0) {
+                positive.push_back(r);
+            } else {
+                zero.push_back(r);
+            }
+        }
+        m_work += m_rays.rows() * D;
+
+        // A restrição é redundante.
+        if (positive.empty()) {
+            for (size_t r : zero) {
+                set(zeros(r), k);
+            }
+            return within_limit();
+        }
+
+        // Pares adjacentes de N × P, com as restrições justas em ambos.
+        std::vector<std::pair<size_t, size_t>> pairs;
+        std::vector<word> common;
+        std::vector<word> candidate(m_words);
+
+        // Raios adjacentes em um cone pontudo de dimensão d são justos em ao
+        // menos d - 2 restrições em comum.
+        size_t pointed = D - m_lines.rows();
+        size_t required = pointed >= 2 ? pointed - 2 : 0;
+
+        for (size_t p : positive) {
+            resources.check_time();
+            for (size_t n : negative) {
+                const word *zp = zeros(p), *zn = zeros(n);
+                size_t count = 0;
+                for (size_t w = 0; w < m_words; w++) {
+                    candidate[w] = zp[w] & zn[w];
+                    count += popcount(candidate[w]);
+                }
+                m_work += m_words;
+
+                if (count >= required && adjacent(p, n, candidate.data())) {
+                    pairs.emplace_back(n, p);
+                    common.insert(common.end(), candidate.begin(),
+                                  candidate.end());
+                }
+                if (!within_limit()) {
+                    return false;
+                }
+            }
+        }
+
+        size_t rows = negative.size() + zero.size() + pairs.size();
+        resources.check_allocation(
+            rows, budget::sum(budget::matrix_bytes<scalar_type>(
+                                  m_rays.rows() + rows, D),
+                              budget::bytes(m_rays.rows() + rows, m_words,
+                                            sizeof(word))));
+
+        matnxm<scalar_type> rays(rows, D);
+        std::vector<word> ray_zeros(rows * m_words);
+        size_t i = 0;
+
+        for (size_t n : negative) {
+            std::copy_n(m_rays.row_data(n), D, rays.row_data(i));
+            std::copy_n(zeros(n), m_words, &ray_zeros[i * m_words]);
+            i++;
+        }
+
+        for (size_t z : zero) {
+            std::copy_n(m_rays.row_data(z), D, rays.row_data(i));
+            std::copy_n(zeros(z), m_words, &ray_zeros[i * m_words]);
+            set(&ray_zeros[i * m_words], k);
+            i++;
+        }
+
+        // Para n ∈ N e p ∈ P, o raio (h · r_p) r_n - (h · r_n) r_p é uma
+        // combinação positiva de r_n e r_p sobre o hiperplano h · y = 0.
+        for (size_t j = 0; j < pairs.size(); j++, i++) {
+            size_t n = pairs[j].first, p = pairs[j].second;
+            rays[i] = m_rays[n] * dots[p] - m_rays[p] * dots[n];
+            normalize(rays.row_data(i));
+
+            std::copy_n(&common[j * m_words], m_words, &ray_zeros[i * m_words]);
+            set(&ray_zeros[i * m_words], k);
+        }
+        m_work += pairs.size() * D;
+
+        m_rays = std::move(rays);
+        m_zeros = std::move(ray_zeros);
+        return within_limit();
+    }
+
+  private:
+    /**
+     * @brief Tolerância relativa dos produtos internos (zero para escalares
+     * exatos).
+     */
+    static constexpr scalar_type tolerance() {
+        return std::numeric_limits<scalar_type>::epsilon() * (1 << 20);
+    }
+
+    /**
+     * @brief Produto interno h · y, arredondado para zero se for pequeno em
+     * relação a |h|₁ |y|∞.
+     */
+    scalar_type dot(const scalar_type* h, const scalar_type* y) const {
+        scalar_type result = 0, h_norm = 0, y_norm = 0;
+        for (size_t j = 0; j < m_dimension; j++) {
+            result += h[j] * y[j];
+            h_norm += h[j] < 0 ? -h[j] : h[j];
+            y_norm = std::max(y_norm, y[j] < 0 ? -y[j] : y[j]);
+        }
+        scalar_type magnitude = result < 0 ? -result : result;
+        return magnitude <= tolerance() * h_norm * y_norm ? 0 : result;
+    }
+
+    /**
+     * @brief Normaliza um vetor para ter coordenada máxima 1 em módulo e
+     * anula as coordenadas desprezíveis, resíduos de cancelamento (somente
+     * para escalares de ponto flutuante).
+     */
+    void normalize(scalar_type* y) const {
+        if (!std::is_floating_point<scalar_type>::value) {
+            return;
+        }
+
+        scalar_type scale = 0;
+        for (size_t j = 0; j < m_dimension; j++) {
+            scale = std::max(scale, y[j] < 0 ? -y[j] : y[j]);
+        }
+        if (scale > 0) {
+            for (size_t j = 0; j < m_dimension; j++) {
+                y[j] /= scale;
+                if ((y[j] < 0 ? -y[j] : y[j]) <= tolerance()) {
+                    y[j] = 0;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Adiciona uma restrição h não ortogonal à linha `pivot` do espaço
+     * de linearidade: as demais linhas e os raios são movidos ao longo do
+     * pivô até o hiperplano h · y = 0, e o pivô, orientado para satisfazer a
+     * restrição, se torna um raio.
+     */
+    void absorb_line(size_t k, size_t pivot,
+                     const std::vector<scalar_type>& line_dots,
+                     const scalar_type* h) {
+        size_t D = m_dimension;
+
+        // Orienta o pivô de forma que h · l < 0.
+        scalar_type s = line_dots[pivot];
+        vecn<scalar_type> l(D);
+        for (size_t j = 0; j < D; j++) {
+            l[j] = s > 0 ? -m_lines.unchecked_at(pivot, j)
+                         : m_lines.unchecked_at(pivot, j);
+        }
+        s = s > 0 ? -s : s;
+
+        // Para s = h · l < 0, y - (h · y / s) l é ortogonal a h; os raios são
+        // escalados por -s > 0 para evitar divisões.
+        matnxm<scalar_type> lines(m_lines.rows() - 1, D);
+        for (size_t i = 0, r = 0; i < m_lines.rows(); i++) {
+            if (i != pivot) {
+                lines[r++] = m_lines[i] * s - l * line_dots[i];
+            }
+        }
+
+        matnxm<scalar_type> rays(m_rays.rows() + 1, D);
+        std::vector<word> ray_zeros((m_rays.rows() + 1) * m_words);
+        for (size_t r = 0; r < m_rays.rows(); r++) {
+            scalar_type d = dot(h, m_rays.row_data(r));
+            rays[r] = m_rays[r] * -s + l * d;
+            normalize(rays.row_data(r));
+
+            std::copy_n(zeros(r), m_words, &ray_zeros[r * m_words]);
+            set(&ray_zeros[r * m_words], k);
+        }
+
+        // As linhas são justas em todas as restrições anteriores.
+        size_t last = m_rays.rows();
+        rays[last] = l;
+        normalize(rays.row_data(last));
+        for (size_t j = 0; j < k; j++) {
+            set(&ray_zeros[last * m_words], j);
+        }
+
+        m_work += (m_lines.rows() + m_rays.rows()) * D;
+        m_lines = std::move(lines);
+        m_rays = std::move(rays);
+        m_zeros = std::move(ray_zeros);
+    }
+
+    /**
+     * @brief Teste combinatório de adjacência: os raios p e n, justos em
+     * `common`, são adjacentes sse nenhum outro raio é justo em `common`.
+     */
+    bool adjacent(size_t p, size_t n, const word* common) {
+        for (size_t r = 0; r < m_rays.rows(); r++) {
+            if (r == p || r == n) {
+                continue;
+            }
+
+            const word* z = zeros(r);
+            bool contains = true;
+            for (size_t w = 0; w < m_words && contains; w++) {
+                contains = (common[w] & ~z[w]) == 0;
+            }
+            if (contains) {
+                m_work += r * m_words;
+                return false;
+            }
+        }
+        m_work += m_rays.rows() * m_words;
+        return true;
+    }
+
+    bool within_limit() const {
+        return m_work_limit == 0 || m_work <= m_work_limit;
+    }
+
+    word* zeros(size_t r) { return &m_zeros[r * m_words]; }
+
+    static void set(word* bits, size_t k) {
+        bits[k / WORD_BITS] |= word(1) << (k % WORD_BITS);
+    }
+
+    static size_t popcount(word w) { return __builtin_popcountll(w); }
+};
+
+namespace internal_dd {
+/**
+ * @brief Tolerância relativa usada na leitura dos raios calculados.
+ */
+template <typename F> constexpr F tolerance() {
+    return std::numeric_limits<F>::epsilon() * 1024;
+}
+
+/**
+ * @brief Maior coordenada, em módulo, das `size` primeiras coordenadas de uma
+ * linha.
+ */
+template <typename F> F max_abs(const F* y, size_t size) {
+    F scale = 0;
+    for (size_t j = 0; j < size; j++) {
+        scale = std::max(scale, y[j] < 0 ? -y[j] : y[j]);
+    }
+    return scale;
+}
+
+/**
+ * @brief Anula as coordenadas desprezíveis de uma linha, em relação à maior
+ * coordenada, e a escala para que as `leading` primeiras coordenadas tenham
+ * máximo 1 em módulo (somente para escalares de ponto flutuante).
+ */
+template <typename F> void clean(F* y, size_t size, size_t leading) {
+    if (!std::is_floating_point<F>::value) {
+        return;
+    }
+
+    F threshold = max_abs(y, size) * tolerance<F>();
+    for (size_t j = 0; j < size; j++) {
+        if ((y[j] < 0 ? -y[j] : y[j]) <= threshold) {
+            y[j] = 0;
+        }
+    }
+
+    F scale = max_abs(y, leading);
+    if (scale > 0) {
+        for (size_t j = 0; j < size; j++) {
+            y[j] /= scale;
+        }
+    }
+}
+
+/**
+ * @brief Base ortogonal do espaço gerado pelas linhas de uma matriz, por
+ * Gram-Schmidt modificado (somente para escalares de ponto flutuante).
+ *
+ * Linhas cuja componente ortogonal às anteriores é desprezível em relação à
+ * sua norma são descartadas.
+ */
+template <typename F> matnxm<F> orthogonal_basis(const matnxm<F>& lines) {
+    size_t n = lines.cols();
+    if (!std::is_floating_point<F>::value) {
+        return matnxm<F>(0, n);
+    }
+
+    std::vector<vecn<F>> basis;
+    for (size_t l = 0; l < lines.rows(); l++) {
+        vecn<F> q(n);
+        std::copy_n(lines.row_data(l), n, q.data());
+        F norm = q * q;
+        for (const auto& e : basis) {
+            F projection = (q * e) / (e * e);
+            for (size_t j = 0; j < n; j++) {
+                q[j] -= projection * e[j];
+            }
+        }
+        if (q * q > norm * tolerance<F>() * tolerance<F>()) {
+            basis.push_back(std::move(q));
+        }
+    }
+
+    matnxm<F> result(basis.size(), n);
+    for (size_t k = 0; k < basis.size(); k++) {
+        std::copy_n(basis[k].data(), n, result.row_data(k));
+    }
+    return result;
+}
+
+/**
+ * @brief Remove das `n` primeiras coordenadas de uma linha as suas componentes
+ * na direção de cada vetor de uma base ortogonal, com n o número de colunas
+ * da base.
+ */
+template <typename F> void orthogonalize(F* y, const matnxm<F>& basis) {
+    size_t n = basis.cols();
+    for (size_t k = 0; k < basis.rows(); k++) {
+        const F* e = basis.row_data(k);
+        F along = 0, norm = 0;
+        for (size_t j = 0; j < n; j++) {
+            along += y[j] * e[j];
+            norm += e[j] * e[j];
+        }
+        F projection = along / norm;
+        for (size_t j = 0; j < n; j++) {
+            y[j] -= projection * e[j];
+        }
+    }
+}
+
+/**
+ * @brief Determina se as `size` primeiras coordenadas de uma linha são nulas.
+ */
+template <typename F> bool zero(const F* y, size_t size) {
+    return std::all_of(y, y + size, [](F x) { return x == 0; });
+}
+}; // namespace internal_dd
+
+/**
+ * @brief Converte um poliedro para a representação por geradores (H → V),
+ * respeitando um limite de operações.
+ *
+ * O poliedro P(A, b) é homogeneizado no cone
+ * {(x, t) : A x - b t <= 0, t >= 0}, cujos raios extremos com t > 0 são os
+ * vértices (x / t) e com t = 0 são os raios de P(A, b).
+ *
+ * @param P Poliedro.
+ * @param resources Orçamento de recursos.
+ * @param work_limit Número máximo de operações (0 se ilimitado).
+ * @param G Referência de saída para os geradores.
+ * @return false se o limite de operações foi excedido.
+ */
+template <typename F>
+bool try_to_generators(const polyhedron<F>& P, const budget& resources,
+                       size_t work_limit, generators<F>& G) {
+    const auto& A = P.A();
+    const auto& b = P.b();
+    size_t n = P.dimensions(), D = n + 1;
+
+    double_description<F> cone(D, A.rows() + 1, work_limit);
+
+    // t >= 0 primeiro, o que elimina cedo a direção de t do espaço de
+    // linearidade.
+    vecn<F> h(D);
+    h[n] = -1;
+    if (!cone.add(h.data(), resources)) {
+        return false;
+    }
+    for (size_t i = 0; i < A.rows(); i++) {
+        std::copy_n(A.row_data(i), n, h.data());
+        h[n] = -b.unchecked_at(i);
+        if (!cone.add(h.data(), resources)) {
+            return false;
+        }
+    }
+
+    // Um raio é um vértice se t não é desprezível em relação a x.
+    const auto& rays = cone.rays();
+    auto vertex = [&](size_t r) {
+        const F* y = rays.row_data(r);
+        return y[n] > internal_dd::max_abs(y, n) * internal_dd::tolerance<F>();
+    };
+
+    size_t vertices = 0;
+    for (size_t r = 0; r < rays.rows(); r++) {
+        vertices += vertex(r);
+    }
+
+    G.vertices = matnxm<F>(vertices, n);
+    G.rays = matnxm<F>(rays.rows() - vertices, n);
+    for (size_t r = 0, v = 0, s = 0; r < rays.rows(); r++) {
+        const F* y = rays.row_data(r);
+        F t = y[n];
+        if (vertex(r)) {
+            F* x = G.vertices.row_data(v++);
+            for (size_t j = 0; j < n; j++) {
+                x[j] = y[j] / t;
+            }
+        } else {
+            std::copy_n(y, n, G.rays.row_data(s++));
+        }
+    }
+
+    const auto& lines = cone.lines();
+    G.lines = matnxm<F>(lines.rows(), n);
+    for (size_t l = 0; l < lines.rows(); l++) {
+        std::copy_n(lines.row_data(l), n, G.lines.row_data(l));
+    }
+    return true;
+}
+
+/**
+ * @brief Converte um poliedro para a representação por geradores (H → V).
+ *
+ * @param P Poliedro.
+ * @param resources Orçamento de recursos.
+ * @return generators<F> Os geradores de P; sem vértices se P for vazio.
+ */
+template <typename F>
+generators<F> to_generators(const polyhedron<F>& P, const budget& resources) {
+    generators<F> G;
+    try_to_generators(P, resources, 0, G);
+    return G;
+}
+
+/**
+ * @brief Converte um poliedro para a representação por geradores (H → V).
+ *
+ * @param P Poliedro.
+ * @return generators<F> Os geradores de P; sem vértices se P for vazio.
+ */
+template <typename F> generators<F> to_generators(const polyhedron<F>& P) {
+    budget unlimited;
+    return to_generators(P, unlimited);
+}
+
+/**
+ * @brief Converte uma representação por geradores para um poliedro (V → H),
+ * respeitando um limite de operações.
+ *
+ * As desigualdades a · x <= β válidas para P correspondem ao cone polar
+ * {(a, s) : a · v + s <= 0, a · r <= 0, a · l = 0}, com β = -s. Seus raios
+ * extremos são as facetas de P, e suas linhas, as equações de P.
+ *
+ * @param G Geradores.
+ * @param resources Orçamento de recursos.
+ * @param work_limit Número máximo de operações (0 se ilimitado).
+ * @param P Referência de saída para o poliedro.
+ * @return false se o limite de operações foi excedido.
+ */
+template <typename F>
+bool try_from_generators(const generators<F>& G, const budget& resources,
+                         size_t work_limit, polyhedron<F>& P) {
+    size_t n = G.dimensions(), D = n + 1;
+
+    // Sem vértices, o poliedro é vazio: 0 <= -1.
+    if (G.empty()) {
+        matnxm<F> A(1, n);
+        vecn<F> b(1);
+        b[0] = -1;
+        P = polyhedron<F>(std::move(A), std::move(b));
+        return true;
+    }
+
+    size_t constraints = G.vertices.rows() + G.rays.rows() + 2 * G.lines.rows();
+    double_description<F> polar(D, constraints, work_limit);
+
+    vecn<F> h(D);
+    auto add = [&](const F* y, F scale, F t) {
+        for (size_t j = 0; j < n; j++) {
+            h[j] = y[j] * scale;
+        }
+        h[n] = t;
+        return polar.add(h.data(), resources);
+    };
+    for (size_t v = 0; v < G.vertices.rows(); v++) {
+        if (!add(G.vertices.row_data(v), 1, 1)) {
+            return false;
+        }
+    }
+    for (size_t r = 0; r < G.rays.rows(); r++) {
+        if (!add(G.rays.row_data(r), 1, 0)) {
+            return false;
+        }
+    }
+    for (size_t l = 0; l < G.lines.rows(); l++) {
+        if (!add(G.lines.row_data(l), 1, 0) ||
+            !add(G.lines.row_data(l), -1, 0)) {
+            return false;
+        }
+    }
+
+    // Cada raio (a, s) do cone polar dá a desigualdade a · x <= -s, exceto
+    // o raio (0, -1) (0 <= 1); cada linha dá uma equação (duas
+    // desigualdades). A condição a · l = 0 só vale a menos de arredondamento,
+    // e um erro em a na direção de uma linha l inclina o poliedro ao longo de
+    // l; por isso, depois da limpeza (que anula coordenadas e mudaria a · l),
+    // a é projetado no complemento ortogonal das linhas.
+    const auto& rays = polar.rays();
+    const auto& lines = polar.lines();
+    matnxm<F> basis = internal_dd::orthogonal_basis(G.lines);
+    std::vector<vecn<F>> rows;
+    for (size_t r = 0; r < rays.rows(); r++) {
+        vecn<F> y(D);
+        std::copy_n(rays.row_data(r), D, y.data());
+        internal_dd::clean(y.data(), D, n);
+        internal_dd::orthogonalize(y.data(), basis);
+        if (!internal_dd::zero(y.data(), n)) {
+            rows.push_back(std::move(y));
+        }
+    }
+    for (size_t l = 0; l < lines.rows(); l++) {
+        vecn<F> y(D);
+        std::copy_n(lines.row_data(l), D, y.data());
+        internal_dd::clean(y.data(), D, n);
+        internal_dd::orthogonalize(y.data(), basis);
+        rows.push_back(-y);
+        rows.push_back(std::move(y));
+    }
+
+    matnxm<F> A(rows.size(), n);
+    vecn<F> b(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        std::copy_n(rows[i].data(), n, A.row_data(i));
+        b.unchecked_at(i) = F(0) - rows[i][n];
+    }
+    P = polyhedron<F>(std::move(A), std::move(b));
+    return true;
+}
+
+/**
+ * @brief Converte uma representação por geradores para um poliedro (V → H).
+ *
+ * @param G Geradores.
+ * @param resources Orçamento de recursos.
+ * @return polyhedron<F> Um poliedro P(A, b) cujas linhas são as facetas do
+ * poliedro gerado (e as suas equações, como pares de desigualdades).
+ */
+template <typename F>
+polyhedron<F> from_generators(const generators<F>& G,
+                              const budget& resources) {
+    polyhedron<F> P;
+    try_from_generators(G, resources, 0, P);
+    return P;
+}
+
+/**
+ * @brief Converte uma representação por geradores para um poliedro (V → H).
+ *
+ * @param G Geradores.
+ * @return polyhedron<F> Um poliedro P(A, b) cujas linhas são as facetas do
+ * poliedro gerado (e as suas equações, como pares de desigualdades).
+ */
+template <typename F> polyhedron<F> from_generators(const generators<F>& G) {
+    budget unlimited;
+    return from_generators(G, unlimited);
+}
+
+/**
+ * @brief Projeção de um poliedro em uma direção pelos geradores: P(A, b) é
+ * convertido para geradores, a direção é adicionada ao espaço de
+ * linearidade, e o resultado é convertido de volta, respeitando um limite de
+ * operações para as duas conversões.
+ *
+ * @param P Poliedro.
+ * @param direction Vetor que indica a direção da projeção.
+ * @param resources Orçamento de recursos.
+ * @param work_limit Número máximo de operações (0 se ilimitado).
+ * @param result Referência de saída para o poliedro de projeção.
+ * @return false se o limite de operações foi excedido.
+ */
+template <typename F>
+bool try_project_generators(const polyhedron<F>& P, const vecn<F>& direction,
+                            const budget& resources, size_t work_limit,
+                            polyhedron<F>& result) {
+    generators<F> G;
+    if (!try_to_generators(P, resources, work_limit, G)) {
+        return false;
+    }
+
+    size_t n = P.dimensions();
+    matnxm<F> lines(G.lines.rows() + 1, n);
+    for (size_t l = 0; l < G.lines.rows(); l++) {
+        std::copy_n(G.lines.row_data(l), n, lines.row_data(l));
+    }
+    lines[G.lines.rows()] = direction;
+    G.lines = std::move(lines);
+
+    return try_from_generators(G, resources, work_limit, result);
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_DOUBLE_DESCRIPTION__
@@ -0,0 +1,662 @@
+#ifndef __POLYHEDRAL_EXTERNAL__
+#define __POLYHEDRAL_EXTERNAL__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "polyhedron.hpp"
+#include "stats.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+namespace internal_rows {
+/**
+ * @brief Normaliza uma linha (coeficientes seguidos do lado direito) in-place.
+ *
+ * Para escalares de ponto flutuante, a linha é multiplicada por uma potência
+ * de 2 tal que o maior coeficiente em módulo fica em [0.5, 1) (ou, se todos
+ * os coeficientes são nulos, o lado direito).
+ *
+ * @param row Ponteiro para os `cols + 1` escalares da linha.
+ * @param cols Número de coeficientes.
+ * @return true se a linha deve ser mantida.
+ * @return false se a linha é trivial (0 <= b, b >= 0).
+ */
+template <typename F> bool normalize(F* row, size_t cols) {
+    auto abs = [](F x) { return x < 0 ? -x : x; };
+
+    F scale = 0;
+    for (size_t j = 0; j < cols; j++) {
+        scale = std::max(scale, abs(row[j]));
+    }
+
+    if (scale == 0) {
+        if (row[cols] >= 0) {
+            return false;
+        }
+        scale = abs(row[cols]);
+    }
+
+    // A escala é uma potência de 2, então a normalização é exata e não
+    // altera o resultado de testes de sinal nos passos seguintes.
+    if (std::is_floating_point<F>::value) {
+        int exponent;
+        std::frexp(scale, &exponent);
+        F factor = std::ldexp(F(1), -exponent);
+        for (size_t j = 0; j <= cols; j++) {
+            row[j] *= factor;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Ordem lexicográfica de linhas com `width` escalares.
+ */
+template <typename F> bool less(const F* a, const F* b, size_t width) {
+    return std::lexicographical_compare(a, a + width, b, b + width);
+}
+
+template <typename F> bool equal(const F* a, const F* b, size_t width) {
+    return std::equal(a, a + width, b);
+}
+}; // namespace internal_rows
+
+/**
+ * @brief Opções da eliminação em memória externa.
+ */
+struct external_options {
+    // Diretório dos arquivos temporários. Se vazio, usa $TMPDIR ou /tmp.
+    std::string directory;
+
+    // Memória máxima, em bytes, usada pelos buffers de linhas de um passo.
+    size_t memory = size_t(64) << 20;
+};
+
+/**
+ * @brief Classe para um erro de leitura ou escrita de arquivos temporários.
+ */
+class spill_error : public std::runtime_error {
+  public:
+    explicit spill_error(const std::string& message)
+        : std::runtime_error("spill file error: " + message) {}
+};
+
+/**
+ * @brief Arquivo temporário de linhas de um poliedro.
+ *
+ * Cada linha ocupa `cols + 1` escalares: os coeficientes a_i seguidos de b_i,
+ * na ordem de bytes nativa (o mesmo layout das linhas de `io/binary.hpp`, sem
+ * cabeçalho). O arquivo é removido do sistema de arquivos assim que é criado,
+ * de forma que o espaço é liberado quando ele é fechado.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class spill_file {
+  private:
+    // Tamanho do buffer de leitura e escrita de cada arquivo.
+    static constexpr size_t BUFFER_SIZE = size_t(64) << 10;
+
+    std::FILE* m_file = nullptr;
+    size_t m_cols = 0;
+    size_t m_rows = 0;
+
+  public:
+    spill_file() = default;
+
+    spill_file(const spill_file&) = delete;
+    spill_file& operator=(const spill_file&) = delete;
+
+    spill_file(spill_file&& other) noexcept { *this = std::move(other); }
+
+    spill_file& operator=(spill_file&& other) noexcept {
+        std::swap(m_file, other.m_file);
+        std::swap(m_cols, other.m_cols);
+        std::swap(m_rows, other.m_rows);
+        return *this;
+    }
+
+    /**
+     * @brief Cria um arquivo temporário vazio.
+     *
+     * @param directory Diretório do arquivo.
+     * @param cols Número de colunas de A.
+     */
+    spill_file(const std::string& directory, size_t cols) : m_cols(cols) {
+        std::string path = directory + "/combpol-spill-XXXXXX";
+        int fd = ::mkstemp(&path[0]);
+        if (fd < 0) {
+            throw spill_error("cannot create temporary file in " + directory);
+        }
+        ::unlink(path.c_str());
+
+        m_file = ::fdopen(fd, "w+b");
+        if (m_file == nullptr) {
+            ::close(fd);
+            throw spill_error("cannot open temporary file");
+        }
+        std::setvbuf(m_file, nullptr, _IOFBF, BUFFER_SIZE);
+    }
+
+    ~spill_file() {
+        if (m_file != nullptr) {
+            std::fclose(m_file);
+        }
+    }
+
+    /**
+     * @brief Número de linhas no arquivo.
+     */
+    size_t rows() const { return m_rows; }
+
+    /**
+     * @brief Número de colunas de A.
+     */
+    size_t cols() const { return m_cols; }
+
+    /**
+     * @brief Número de escalares de uma linha (coeficientes e lado direito).
+     */
+    size_t width() const { return m_cols + 1; }
+
+    /**
+     * @brief Adiciona uma linha ao fim do arquivo.
+     *
+     * @param row Ponteiro para os `width()` escalares da linha.
+     */
+    void write(const F* row) {
+        if (std::fwrite(row, sizeof(F), width(), m_file) != width()) {
+            throw spill_error("write failed");
+        }
+        m_rows++;
+    }
+
+    /**
+     * @brief Volta a leitura para a primeira linha do arquivo.
+     */
+    void rewind() const {
+        if (std::fflush(m_file) != 0 || std::fseek(m_file, 0, SEEK_SET) != 0) {
+            throw spill_error("seek failed");
+        }
+    }
+
+    /**
+     * @brief Lê a próxima linha do arquivo.
+     *
+     * @param row Ponteiro para `width()` escalares de saída.
+     * @return true se uma linha foi lida.
+     * @return false se o fim do arquivo foi atingido.
+     */
+    bool read(F* row) const {
+        size_t read = std::fread(row, sizeof(F), width(), m_file);
+        if (read == width()) {
+            return true;
+        }
+        if (read != 0 || std::ferror(m_file)) {
+            throw spill_error("read failed");
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Poliedro armazenado em disco, para eliminações de Fourier-Motzkin
+ * cujo resultado não cabe em memória.
+ *
+ * Cada passo de eliminação lê as linhas de N em blocos e, para cada bloco,
+ * percorre as linhas de P uma a uma; as linhas geradas são acumuladas em um
+ * buffer que, quando cheio, é ordenado, tem duplicatas removidas e é escrito em
+ * um arquivo temporário (uma "corrida"). As corridas são então intercaladas,
+ * também removendo duplicatas, no arquivo que alimenta o próximo passo. A
+ * memória usada é limitada por `external_options::memory`, independente do
+ * número de linhas.
+ *
+ * Diferente de `polyhedron::project`, as linhas do resultado são
+ * normalizadas (para escalares de ponto flutuante, são multiplicadas por uma
+ * potência de 2 tal que o maior coeficiente em módulo fica em [0.5, 1)),
+ * ordenadas e sem duplicatas, e linhas triviais (0 <= b com b >= 0) são
+ * descartadas.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class external_polyhedron {
+  private:
+    // Tamanho do buffer de leitura de cada corrida durante a intercalação.
+    static constexpr size_t MERGE_BUFFER = size_t(64) << 10;
+
+    external_options m_options;
+    spill_file<F> m_rows;
+
+    // Se verdadeiro, alguma linha é da forma 0 <= b com b < 0.
+    bool m_infeasible = false;
+
+  public:
+    using scalar_type = F;
+
+    external_polyhedron(external_polyhedron&&) = default;
+    external_polyhedron& operator=(external_polyhedron&&) = default;
+
+    /**
+     * @brief Copia um poliedro em memória para o disco.
+     *
+     * @param P Poliedro.
+     * @param options Opções da eliminação em memória externa.
+     */
+    external_polyhedron(const polyhedron<scalar_type>& P,
+                        const external_options& options)
+        : external_polyhedron(options, P.dimensions()) {
+        const auto& A = P.A();
+        std::vector<scalar_type> row(m_rows.width());
+        for (size_t i = 0; i < A.rows(); i++) {
+            std::copy(A.row_data(i), A.row_data(i) + A.cols(), row.begin());
+            row[A.cols()] = P.b().unchecked_at(i);
+            m_rows.write(row.data());
+        }
+    }
+
+    /**
+     * @brief Número de dimensões do espaço vetorial no qual o poliedro existe.
+     */
+    size_t dimensions() const { return m_rows.cols(); }
+
+    /**
+     * @brief Número de linhas do poliedro.
+     */
+    size_t rows() const { return m_rows.rows(); }
+
+    /**
+     * @brief Percorre as linhas do poliedro, em ordem.
+     *
+     * @tparam Visitor Tipo da função chamada para cada linha.
+     *
+     * @param visit Função chamada com um ponteiro para os `dimensions()`
+     * coeficientes da linha e o lado direito.
+     */
+    template <typename Visitor> void for_each_row(Visitor visit) const {
+        std::vector<scalar_type> row(m_rows.width());
+        m_rows.rewind();
+        while (m_rows.read(row.data())) {
+            visit(static_cast<const scalar_type*>(row.data()),
+                  row[dimensions()]);
+        }
+    }
+
+    /**
+     * @brief Carrega o poliedro em memória.
+     *
+     * @return polyhedron<scalar_type> O poliedro P(A, b) correspondente.
+     */
+    polyhedron<scalar_type> load() const {
+        matnxm<scalar_type> A(rows(), dimensions());
+        vecn<scalar_type> b(rows());
+
+        size_t i = 0;
+        for_each_row([&](const scalar_type* a, scalar_type rhs) {
+            std::copy(a, a + dimensions(), A.row_data(i));
+            b.unchecked_at(i++) = rhs;
+        });
+        return {std::move(A), std::move(b)};
+    }
+
+    /**
+     * @brief Calcula o poliedro de projeção na direção dada (vide
+     * `polyhedron::project`).
+     *
+     * @param direction Vetor que indica a direção da projeção.
+     * @param resources Orçamento de recursos (apenas o tempo é limitado).
+     * @return external_polyhedron O poliedro de projeção, em disco.
+     */
+    external_polyhedron project(const vecn<scalar_type>& direction,
+                                budget& resources) const {
+        internal::validate("cannot project polyhedron on direction with "
+                           "incompatible dimensions",
+                           [&]() { return dimensions() == direction.size(); });
+
+        resources.begin_step(budget::no_variable);
+        return eliminate(direction, budget::no_variable, resources);
+    }
+
+    external_polyhedron project(const vecn<scalar_type>& direction) const {
+        budget unlimited;
+        return project(direction, unlimited);
+    }
+
+    /**
+     * @brief Colapsa uma dimensão do poliedro (vide
+     * `polyhedron::collapse_dimension`).
+     *
+     * @param coord Índice da dimensão a ser colapsada.
+     * @param resources Orçamento de recursos (apenas o tempo é limitado).
+     * @return external_polyhedron O poliedro resultante, em disco.
+     */
+    external_polyhedron collapse_dimension(size_t coord,
+                                           budget& resources) const {
+        internal::validate("cannot project polyhedron on direction with "
+                           "incompatible dimensions",
+                           [&]() { return coord < dimensions(); });
+
+        vecn<scalar_type> direction(dimensions());
+        direction[coord] = 1;
+
+        resources.begin_step(coord);
+        return eliminate(direction, coord, resources);
+    }
+
+    external_polyhedron collapse_dimension(size_t coord) const {
+        budget unlimited;
+        return collapse_dimension(coord, unlimited);
+    }
+
+    /**
+     * @brief Determina se o poliedro é vazio (vide `polyhedron::empty`).
+     *
+     * @param resources Orçamento de recursos (apenas o tempo é limitado).
+     * @return true se o poliedro for vazio.
+     * @return false caso contrário.
+     */
+    bool empty(budget& resources) const {
+        if (m_infeasible) {
+            return true;
+        }
+
+        external_polyhedron projection = collapse_dimension(0, resources);
+        for (size_t i = 1; i < dimensions() && !projection.m_infeasible; i++) {
+            projection = projection.collapse_dimension(i, resources);
+        }
+
+        // Como toda dimensão foi colapsada e as linhas triviais são
+        // descartadas, só restam linhas da forma 0 <= b com b < 0.
+        return projection.m_infeasible;
+    }
+
+    bool empty() const {
+        budget unlimited;
+        return empty(unlimited);
+    }
+
+  private:
+    external_polyhedron(const external_options& options, size_t cols)
+        : m_options(options), m_rows(directory(options), cols) {}
+
+    static std::string directory(const external_options& options) {
+        if (!options.directory.empty()) {
+            return options.directory;
+        }
+        const char* tmpdir = std::getenv("TMPDIR");
+        return tmpdir != nullptr && *tmpdir != '\0' ? tmpdir : "/tmp";
+    }
+
+    size_t width() const { return m_rows.width(); }
+
+    size_t row_bytes() const { return width() * sizeof(scalar_type); }
+
+    /**
+     * @brief Número de linhas que cabem em uma fração da memória disponível,
+     * com um custo adicional de `extra` bytes por linha (no mínimo 1).
+     */
+    size_t capacity(size_t fraction, size_t extra = 0) const {
+        return std::max<size_t>(1, m_options.memory / fraction /
+                                       (row_bytes() + extra));
+    }
+
+    static scalar_type dot(const scalar_type* row,
+                           const vecn<scalar_type>& direction) {
+        const scalar_type* c = direction.data();
+        scalar_type result = 0;
+        for (size_t j = 0; j < direction.size(); j++) {
+            result += row[j] * c[j];
+        }
+        return result;
+    }
+
+    // Normalização e ordem das linhas (vide `internal_rows`).
+    bool normalize(scalar_type* row) const {
+        return internal_rows::normalize(row, dimensions());
+    }
+
+    bool less(const scalar_type* a, const scalar_type* b) const {
+        return internal_rows::less(a, b, width());
+    }
+
+    bool equal(const scalar_type* a, const scalar_type* b) const {
+        return internal_rows::equal(a, b, width());
+    }
+
+    /**
+     * @brief Buffer de linhas geradas, escrito em corridas ordenadas e sem
+     * duplicatas.
+     */
+    class run_writer {
+      private:
+        const external_polyhedron& m_owner;
+        std::string m_directory;
+        size_t m_capacity;
+        size_t m_fan_in;
+        std::vector<scalar_type> m_buffer;
+        std::vector<size_t> m_order;
+        std::vector<spill_file<scalar_type>> m_runs;
+        std::vector<size_t> m_levels;
+        bool m_infeasible = false;
+
+      public:
+        run_writer(const external_polyhedron& owner, size_t capacity,
+                   size_t fan_in)
+            : m_owner(owner), m_directory(directory(owner.m_options)),
+              m_capacity(capacity), m_fan_in(fan_in) {
+            m_buffer.reserve(capacity * owner.width());
+            m_order.reserve(capacity);
+        }
+
+        /**
+         * @brief Adiciona uma linha (já normalizada) ao buffer.
+         */
+        void push(const scalar_type* row) {
+            size_t cols = m_owner.dimensions();
+            m_infeasible = m_infeasible ||
+                           (row[cols] < 0 &&
+                            std::all_of(row, row + cols,
+                                        [](scalar_type x) { return x == 0; }));
+
+            m_buffer.insert(m_buffer.end(), row, row + m_owner.width());
+            if (m_buffer.size() == m_capacity * m_owner.width()) {
+                flush();
+            }
+        }
+
+        /**
+         * @brief Escreve as linhas restantes e intercala todas as corridas em
+         * um único arquivo.
+         */
+        external_polyhedron finish() {
+            flush();
+
+            external_polyhedron result(m_owner.m_options, m_owner.dimensions());
+            merge(0, result.m_rows);
+            result.m_infeasible = m_infeasible;
+            return result;
+        }
+
+      private:
+        void flush() {
+            size_t width = m_owner.width();
+            size_t rows = m_buffer.size() / width;
+            if (rows == 0) {
+                return;
+            }
+
+            const scalar_type* data = m_buffer.data();
+            m_order.resize(rows);
+            for (size_t i = 0; i < rows; i++) {
+                m_order[i] = i * width;
+            }
+            std::sort(m_order.begin(), m_order.end(),
+                      [&](size_t a, size_t b) {
+                          return m_owner.less(data + a, data + b);
+                      });
+
+            spill_file<scalar_type> run(m_directory, m_owner.dimensions());
+            for (size_t i = 0; i < rows; i++) {
+                if (i == 0 || !m_owner.equal(data + m_order[i],
+                                             data + m_order[i - 1])) {
+                    run.write(data + m_order[i]);
+                }
+            }
+            m_buffer.clear();
+
+            // Limita o número de corridas abertas: sempre que as últimas
+            // `m_fan_in` corridas estão no mesmo nível, elas são intercaladas
+            // em uma corrida do nível seguinte. Assim, cada linha é reescrita
+            // O(log(corridas)) vezes.
+            m_runs.push_back(std::move(run));
+            m_levels.push_back(0);
+            while (m_runs.size() >= m_fan_in &&
+                   m_levels[m_runs.size() - m_fan_in] == m_levels.back()) {
+                size_t first = m_runs.size() - m_fan_in,
+                       level = m_levels.back() + 1;
+                spill_file<scalar_type> merged(m_directory,
+                                               m_owner.dimensions());
+                merge(first, merged);
+                m_runs.push_back(std::move(merged));
+                m_levels.push_back(level);
+            }
+        }
+
+        /**
+         * @brief Intercala as corridas a partir de `first` em `output`,
+         * removendo duplicatas, e as descarta.
+         */
+        void merge(size_t first, spill_file<scalar_type>& output) {
+            size_t width = m_owner.width();
+            size_t k = m_runs.size() - first;
+
+            std::vector<scalar_type> heads(k * width);
+            auto greater = [&](size_t a, size_t b) {
+                return m_owner.less(&heads[b * width], &heads[a * width]);
+            };
+            std::priority_queue<size_t, std::vector<size_t>, decltype(greater)>
+                queue(greater);
+
+            for (size_t r = 0; r < k; r++) {
+                m_runs[first + r].rewind();
+                if (m_runs[first + r].read(&heads[r * width])) {
+                    queue.push(r);
+                }
+            }
+
+            std::vector<scalar_type> last(width);
+            bool any = false;
+            while (!queue.empty()) {
+                size_t r = queue.top();
+                queue.pop();
+
+                const scalar_type* head = &heads[r * width];
+                if (!any || !m_owner.equal(head, last.data())) {
+                    output.write(head);
+                    std::copy(head, head + width, last.begin());
+                    any = true;
+                }
+
+                if (m_runs[first + r].read(&heads[r * width])) {
+                    queue.push(r);
+                }
+            }
+
+            m_runs.erase(m_runs.begin() + first, m_runs.end());
+            m_levels.erase(m_levels.begin() + first, m_levels.end());
+        }
+    };
+
+    /**
+     * @brief Passo de eliminação de Fourier-Motzkin em memória externa.
+     */
+    external_polyhedron eliminate(const vecn<scalar_type>& direction,
+                                  size_t variable, budget& resources) const {
+        step_timer timer(variable, true);
+        std::string dir = directory(m_options);
+
+        // A memória é dividida entre o bloco de linhas de N (1/4), o buffer de
+        // linhas geradas e seus índices (1/2) e os buffers de leitura das
+        // corridas durante a intercalação (1/4).
+        size_t block_rows = capacity(4);
+        size_t run_rows = capacity(2, sizeof(size_t));
+        size_t fan_in = std::max<size_t>(
+            2, std::min<size_t>(256, m_options.memory / 4 /
+                                         (MERGE_BUFFER + row_bytes())));
+
+        run_writer output(*this, run_rows, fan_in);
+        spill_file<scalar_type> N(dir, dimensions()), P(dir, dimensions());
+
+        // Particiona as linhas: as linhas de Z vão diretamente para a saída, e
+        // as de N e P para arquivos próprios.
+        size_t zero = 0;
+        std::vector<scalar_type> row(width());
+        m_rows.rewind();
+        while (m_rows.read(row.data())) {
+            scalar_type d = dot(row.data(), direction);
+            if (d < 0) {
+                N.write(row.data());
+            } else if (d > 0) {
+                P.write(row.data());
+            } else {
+                zero++;
+                if (normalize(row.data())) {
+                    output.push(row.data());
+                }
+            }
+        }
+
+        // Combina cada bloco de linhas de N com todas as linhas de P.
+        std::vector<scalar_type> block(block_rows * width());
+        std::vector<scalar_type> np(block_rows);
+        std::vector<scalar_type> combined(width());
+
+        N.rewind();
+        for (size_t first = 0; first < N.rows(); first += block_rows) {
+            size_t count = std::min(block_rows, N.rows() - first);
+            for (size_t s = 0; s < count; s++) {
+                N.read(&block[s * width()]);
+                np[s] = dot(&block[s * width()], direction);
+            }
+
+            P.rewind();
+            while (P.read(row.data())) {
+                resources.check_time();
+
+                scalar_type pp = dot(row.data(), direction);
+                for (size_t s = 0; s < count; s++) {
+                    const scalar_type* a_s = &block[s * width()];
+                    for (size_t j = 0; j < width(); j++) {
+                        combined[j] = a_s[j] * pp - row[j] * np[s];
+                    }
+                    if (normalize(combined.data())) {
+                        output.push(combined.data());
+                    }
+                }
+            }
+        }
+
+        external_polyhedron result = output.finish();
+        timer.finish(N.rows(), zero, P.rows(), result.rows(),
+                     zero + N.rows() * P.rows() - result.rows(),
+                     budget::bytes(result.rows(), width(), sizeof(scalar_type)));
+        return result;
+    }
+};
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_EXTERNAL__
@@ -0,0 +1,926 @@
+#ifndef __POLYHEDRAL_FILTERED__
+#define __POLYHEDRAL_FILTERED__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "column_index.hpp"
+#include "polyhedron.hpp"
+#include "stats.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+namespace internal_filtered {
+/**
+ * @brief Número racional diádico exato (-1)^s · m · 2^e, com a mantissa m
+ * inteira de precisão arbitrária, em palavras de 32 bits da menos para a mais
+ * significativa.
+ *
+ * Todo escalar de ponto flutuante finito é um diádico, e somas e produtos de
+ * diádicos são diádicos; por isso as linhas geradas pela eliminação a partir
+ * de linhas de entrada em ponto flutuante podem ser calculadas exatamente.
+ */
+class dyadic {
+  private:
+    std::vector<std::uint32_t> m_limbs;
+    long m_exponent = 0;
+    bool m_negative = false;
+
+    /**
+     * @brief Remove as palavras nulas das extremidades da mantissa.
+     */
+    void trim() {
+        while (!m_limbs.empty() && m_limbs.back() == 0) {
+            m_limbs.pop_back();
+        }
+        size_t low = 0;
+        while (low < m_limbs.size() && m_limbs[low] == 0) {
+            low++;
+        }
+        m_limbs.erase(m_limbs.begin(), m_limbs.begin() + low);
+        m_exponent += long(32 * low);
+        if (m_limbs.empty()) {
+            m_exponent = 0;
+            m_negative = false;
+        }
+    }
+
+    /**
+     * @brief Mantissa de x escrita com um expoente menor ou igual ao seu.
+     */
+    static std::vector<std::uint32_t> shifted(const dyadic& x, long exponent) {
+        size_t bits = size_t(x.m_exponent - exponent);
+        size_t words = bits / 32, rest = bits % 32;
+
+        std::vector<std::uint32_t> out(words);
+        out.reserve(words + x.m_limbs.size() + 1);
+        std::uint32_t carry = 0;
+        for (std::uint32_t limb : x.m_limbs) {
+            out.push_back(rest == 0 ? limb : (limb << rest) | carry);
+            carry = rest == 0 ? 0 : limb >> (32 - rest);
+        }
+        out.push_back(carry);
+        return out;
+    }
+
+    /**
+     * @brief Soma de dois diádicos.
+     */
+    static dyadic sum(const dyadic& x, const dyadic& y) {
+        if (x.m_limbs.empty()) {
+            return y;
+        }
+        if (y.m_limbs.empty()) {
+            return x;
+        }
+
+        dyadic r;
+        r.m_exponent = std::min(x.m_exponent, y.m_exponent);
+        auto a = shifted(x, r.m_exponent), b = shifted(y, r.m_exponent);
+        size_t n = std::max(a.size(), b.size()) + 1;
+        a.resize(n);
+        b.resize(n);
+
+        // Com sinais diferentes, subtrai a menor magnitude da maior.
+        bool subtract = x.m_negative != y.m_negative;
+        r.m_negative = x.m_negative;
+        if (subtract &&
+            std::lexicographical_compare(a.rbegin(), a.rend(), b.rbegin(),
+                                         b.rend())) {
+            std::swap(a, b);
+            r.m_negative = y.m_negative;
+        }
+
+        r.m_limbs.resize(n);
+        std::uint64_t carry = 0;
+        for (size_t k = 0; k < n; k++) {
+            std::uint64_t t;
+            if (subtract) {
+                t = std::uint64_t(a[k]) - b[k] - carry;
+                carry = a[k] < std::uint64_t(b[k]) + carry;
+            } else {
+                t = std::uint64_t(a[k]) + b[k] + carry;
+                carry = t >> 32;
+            }
+            r.m_limbs[k] = std::uint32_t(t);
+        }
+        r.trim();
+        return r;
+    }
+
+  public:
+    dyadic() = default;
+
+    /**
+     * @brief Converte exatamente um escalar de ponto flutuante finito.
+     */
+    template <typename F> explicit dyadic(F x) {
+        static_assert(std::numeric_limits<F>::digits <= 64,
+                      "mantissa must fit in 64 bits");
+        if (x == 0) {
+            return;
+        }
+        int exponent;
+        F mantissa = std::frexp(x < 0 ? -x : x, &exponent);
+        auto bits = std::uint64_t(
+            std::ldexp(mantissa, std::numeric_limits<F>::digits));
+
+        m_limbs = {std::uint32_t(bits), std::uint32_t(bits >> 32)};
+        m_exponent = long(exponent) - std::numeric_limits<F>::digits;
+        m_negative = x < 0;
+        trim();
+    }
+
+    /**
+     * @brief Sinal do número: -1, 0 ou 1.
+     */
+    int sign() const {
+        return m_limbs.empty() ? 0 : (m_negative ? -1 : 1);
+    }
+
+    friend dyadic operator*(const dyadic& x, const dyadic& y) {
+        dyadic r;
+        if (x.m_limbs.empty() || y.m_limbs.empty()) {
+            return r;
+        }
+
+        size_t n = x.m_limbs.size(), m = y.m_limbs.size();
+        r.m_limbs.assign(n + m, 0);
+        for (size_t i = 0; i < n; i++) {
+            std::uint64_t carry = 0;
+            for (size_t j = 0; j < m; j++) {
+                std::uint64_t t = std::uint64_t(x.m_limbs[i]) * y.m_limbs[j] +
+                                  r.m_limbs[i + j] + carry;
+                r.m_limbs[i + j] = std::uint32_t(t);
+                carry = t >> 32;
+            }
+            r.m_limbs[i + m] = std::uint32_t(carry);
+        }
+        r.m_exponent = x.m_exponent + y.m_exponent;
+        r.m_negative = x.m_negative != y.m_negative;
+        r.trim();
+        return r;
+    }
+
+    friend dyadic operator-(const dyadic& x, const dyadic& y) {
+        dyadic negated = y;
+        negated.m_negative = !y.m_negative && !y.m_limbs.empty();
+        return sum(x, negated);
+    }
+};
+
+// Índice de origem ausente (linhas copiadas de Z).
+static constexpr size_t no_row = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief Dados de uma linha da cadeia de eliminação filtrada.
+ *
+ * @tparam S Tipo de escalar das linhas.
+ */
+template <typename S> struct row_info {
+    // Cota do erro absoluto de todos os escalares da linha (coeficientes e
+    // lado direito) em relação à linha exata, e cota do maior módulo entre
+    // eles.
+    S error;
+    S norm;
+
+    // Para as linhas exatas (erro zero), uma potência 2^q tal que todos os
+    // escalares da linha são múltiplos inteiros de 2^q.
+    S unit;
+
+    // Linhas de origem no nível anterior: s ∈ N e t ∈ P, ou s ∈ Z e
+    // `no_row`.
+    size_t first;
+    size_t second;
+
+    // Se verdadeiro, os zeros da linha são exatos, mesmo com erro não nulo:
+    // nenhum deles veio de um cancelamento ou de um underflow.
+    bool exact_zeros;
+};
+
+/**
+ * @brief Nível da cadeia de eliminação filtrada.
+ */
+template <typename S> struct level {
+    polyhedron<S> P;
+
+    // Coordenadas originais das colunas de P.
+    std::vector<size_t> columns;
+
+    std::vector<row_info<S>> info;
+
+    // Coluna eliminada no passo que sai do nível.
+    size_t column = 0;
+};
+
+/**
+ * @brief Linha de um nível recalculada na precisão da entrada, a partir das
+ * linhas de entrada, com os escalares seguidos do lado direito.
+ */
+template <typename F> struct refined_row {
+    std::vector<F> values;
+    row_info<F> info;
+};
+
+template <typename T> T absolute(T x) { return x < 0 ? -x : x; }
+
+/**
+ * @brief Maior potência 2^q tal que x é múltiplo inteiro de 2^q (ou
+ * infinito, se x é zero).
+ */
+template <typename T> T lowest_bit(T x) {
+    if (x == 0) {
+        return std::numeric_limits<T>::infinity();
+    }
+    int exponent;
+    T mantissa = std::frexp(absolute(x), &exponent);
+    exponent -= std::numeric_limits<T>::digits;
+    auto bits =
+        std::uint64_t(std::ldexp(mantissa, std::numeric_limits<T>::digits));
+    for (; bits % 2 == 0; bits /= 2) {
+        exponent++;
+    }
+    return std::ldexp(T(1), exponent);
+}
+
+/**
+ * @brief Sinal de um valor com a sua cota de erro, ou 2 se a cota não o
+ * decide.
+ */
+template <typename T> int filtered_sign(T v, T e, bool exact_zero) {
+    if (v > e) {
+        return 1;
+    }
+    if (v < -e) {
+        return -1;
+    }
+    if (e == 0 || (v == 0 && exact_zero)) {
+        return v > 0 ? 1 : (v < 0 ? -1 : 0);
+    }
+    return 2;
+}
+
+/**
+ * @brief Cotas da combinação x y_c - y x_c das linhas x e y, exceto
+ * `exact_zeros` e as linhas de origem.
+ *
+ * Com |x - X| <= e_x e |y - Y| <= e_y em cada escalar, o erro de
+ * x_j y_c - y_j x_c é limitado por
+ *  (M_x + |x_c|) e_y + (M_y + |y_c|) e_x + 2 e_x e_y
+ *    + γ_2 (M_x |y_c| + M_y |x_c|) + η,
+ * em que M é a cota do maior módulo da linha, γ_2 = 2u / (1 - 2u) e η cobre
+ * o underflow dos produtos. As cotas são aumentadas para cobrir o
+ * arredondamento do seu próprio cálculo.
+ *
+ * Se as duas linhas são exatas, com escalares múltiplos de 2^q_x e 2^q_y, o
+ * resultado é múltiplo de 2^(q_x + q_y) e é calculado sem arredondamento se
+ * M_x |y_c| + M_y |x_c| < 2^(q_x + q_y) / ε (com uma margem de um bit para o
+ * arredondamento da soma).
+ *
+ * @param xc Módulo de x_c.
+ * @param yc Módulo de y_c.
+ */
+template <typename T>
+row_info<T> combination(const row_info<T>& x, const row_info<T>& y, T xc,
+                        T yc) {
+    constexpr T epsilon = std::numeric_limits<T>::epsilon(), u = epsilon / 2,
+                gamma = 2 * u / (1 - 2 * u), margin = 1 + 16 * u,
+                eta = 2 * std::numeric_limits<T>::denorm_min();
+
+    row_info<T> result;
+    T magnitude = x.norm * yc + y.norm * xc;
+    result.norm = magnitude * margin;
+    result.unit = x.unit * y.unit;
+    result.exact_zeros = true;
+    if (x.error == 0 && y.error == 0 && magnitude < result.unit / epsilon) {
+        result.error = 0;
+    } else {
+        result.error = ((x.norm + xc) * y.error + (y.norm + yc) * x.error +
+                        2 * x.error * y.error + gamma * magnitude + eta) *
+                       margin;
+    }
+    return result;
+}
+
+/**
+ * @brief Cadeia de eliminação de Fourier-Motzkin com decisões de sinal
+ * filtradas.
+ *
+ * Cada linha gerada guarda uma cota rigorosa do seu erro em relação à linha
+ * que a eliminação em aritmética exata geraria. O sinal de um escalar é
+ * decidido pelo intervalo [v - e, v + e] quando ele não contém zero; caso
+ * contrário, a linha é recalculada exatamente, com diádicos, a partir das
+ * linhas de entrada que a originaram.
+ *
+ * Todas as decisões de sinal (partições N/Z/P e o teste final de vazio) são
+ * exatas, e as linhas geradas são as da eliminação exata (a menos de erros
+ * de arredondamento nos seus valores).
+ *
+ * Com S menos preciso que F, as linhas são guardadas e combinadas em S, o
+ * que reduz a memória movida por passo. Um sinal não decidido em S é
+ * recalculado primeiro em F, também a partir das linhas de entrada e com a
+ * sua cota de erro, e só então exatamente. Se o erro relativo de alguma
+ * linha passa de metade dos bits da mantissa de S (ou se há overflow), a
+ * cadeia é marcada como imprecisa: a partir daí, a maior parte dos sinais
+ * exigiria recálculos, e a eliminação deve ser refeita em F.
+ *
+ * @tparam F Tipo de escalar de ponto flutuante da entrada.
+ * @tparam S Tipo de escalar de ponto flutuante das linhas geradas.
+ */
+template <typename F, typename S = F> class chain {
+  private:
+    static_assert(std::is_floating_point<F>::value &&
+                      std::is_floating_point<S>::value,
+                  "filtered arithmetic requires a floating point scalar");
+
+    // Se verdadeiro, os sinais não decididos em S são recalculados em F
+    // antes do recálculo exato.
+    static constexpr bool screening =
+        std::numeric_limits<S>::digits < std::numeric_limits<F>::digits;
+
+    polyhedron<F> m_input;
+    std::vector<level<S>> m_levels;
+
+    // Linhas recalculadas em F e exatamente, por nível.
+    std::vector<std::unordered_map<size_t, refined_row<F>>> m_refined;
+    std::vector<std::unordered_map<size_t, std::vector<dyadic>>> m_exact;
+
+    size_t m_refined_signs = 0;
+    size_t m_exact_signs = 0;
+    bool m_coarse = false;
+
+    /**
+     * @brief Marca a cadeia como imprecisa se o erro de uma linha em S é
+     * grande demais.
+     */
+    void check_precision(const row_info<S>& info) {
+        if (screening) {
+            S tolerance =
+                std::ldexp(S(1), -std::numeric_limits<S>::digits / 2);
+            m_coarse |= !std::isfinite(info.norm) ||
+                        !(info.error <= info.norm * tolerance);
+        }
+    }
+
+    /**
+     * @brief Linha de um nível recalculada em F.
+     */
+    const refined_row<F>& refined(size_t k, size_t i) {
+        auto found = m_refined[k].find(i);
+        if (found != m_refined[k].end()) {
+            return found->second;
+        }
+
+        refined_row<F> row;
+        if (k == 0) {
+            const F* a = m_input.A().row_data(i);
+            size_t n = m_input.dimensions();
+            row.values.assign(a, a + n);
+            row.values.push_back(m_input.b().unchecked_at(i));
+            row.info = {0, 0, std::numeric_limits<F>::infinity(), i, no_row,
+                        true};
+            for (F v : row.values) {
+                row.info.norm = std::max(row.info.norm, absolute(v));
+                row.info.unit = std::min(row.info.unit, lowest_bit(v));
+            }
+        } else {
+            size_t c = m_levels[k - 1].column;
+            const auto& origin = m_levels[k].info[i];
+            const auto& x = refined(k - 1, origin.first);
+            if (origin.second == no_row) {
+                row.info = x.info;
+                for (size_t j = 0; j < x.values.size(); j++) {
+                    if (j != c) {
+                        row.values.push_back(x.values[j]);
+                    }
+                }
+            } else {
+                const auto& y = refined(k - 1, origin.second);
+                F xc = x.values[c], yc = y.values[c];
+                row.info =
+                    combination(x.info, y.info, absolute(xc), absolute(yc));
+                row.info.exact_zeros =
+                    x.info.exact_zeros && y.info.exact_zeros;
+                for (size_t j = 0; j < x.values.size(); j++) {
+                    if (j == c) {
+                        continue;
+                    }
+                    F v = x.values[j] * yc - y.values[j] * xc;
+                    row.info.exact_zeros &=
+                        v != 0 || (x.values[j] == 0 && y.values[j] == 0);
+                    row.values.push_back(v);
+                }
+            }
+        }
+        return m_refined[k].emplace(i, std::move(row)).first->second;
+    }
+
+    /**
+     * @brief Linha exata (coeficientes e lado direito) de um nível.
+     */
+    const std::vector<dyadic>& exact_row(size_t k, size_t i) {
+        auto found = m_exact[k].find(i);
+        if (found != m_exact[k].end()) {
+            return found->second;
+        }
+
+        std::vector<dyadic> row;
+        if (k == 0) {
+            const F* a = m_input.A().row_data(i);
+            for (size_t j = 0; j < m_input.dimensions(); j++) {
+                row.emplace_back(a[j]);
+            }
+            row.emplace_back(m_input.b().unchecked_at(i));
+        } else {
+            // As referências para os valores do mapa continuam válidas após
+            // novas inserções.
+            size_t c = m_levels[k - 1].column;
+            const auto& origin = m_levels[k].info[i];
+            const auto& x = exact_row(k - 1, origin.first);
+            if (origin.second == no_row) {
+                for (size_t j = 0; j < x.size(); j++) {
+                    if (j != c) {
+                        row.push_back(x[j]);
+                    }
+                }
+            } else {
+                const auto& y = exact_row(k - 1, origin.second);
+                for (size_t j = 0; j < x.size(); j++) {
+                    if (j != c) {
+                        row.push_back(x[j] * y[c] - y[j] * x[c]);
+                    }
+                }
+            }
+        }
+        return m_exact[k].emplace(i, std::move(row)).first->second;
+    }
+
+    /**
+     * @brief Sinal de x_j y_c - y_j x_c, para as linhas s e t do último nível,
+     * quando o valor calculado em S não o decide.
+     */
+    int combination_sign(size_t s, size_t t, size_t j, size_t c) {
+        size_t k = m_levels.size() - 1;
+        if (screening) {
+            const auto& x = refined(k, s);
+            const auto& y = refined(k, t);
+            F xc = x.values[c], yc = y.values[c];
+            F v = x.values[j] * yc - y.values[j] * xc;
+            auto info = combination(x.info, y.info, absolute(xc), absolute(yc));
+            bool exact_zero =
+                x.info.exact_zeros && y.info.exact_zeros &&
+                (v != 0 || (x.values[j] == 0 && y.values[j] == 0));
+            int sign = filtered_sign(v, info.error, exact_zero);
+            if (sign != 2) {
+                m_refined_signs++;
+                return sign;
+            }
+        }
+
+        m_exact_signs++;
+        const auto& x = exact_row(k, s);
+        const auto& y = exact_row(k, t);
+        return (x[j] * y[c] - y[j] * x[c]).sign();
+    }
+
+  public:
+    /**
+     * @brief Constrói a cadeia com um poliedro de entrada, cujos escalares
+     * são considerados exatos.
+     *
+     * @param P Poliedro com escalares finitos.
+     */
+    explicit chain(const polyhedron<F>& P)
+        : m_input(P), m_levels(1), m_refined(1), m_exact(1) {
+        const auto& A = P.A();
+        const auto& b = P.b();
+        internal::validate(
+            "cannot use filtered arithmetic with non-finite scalars", [&]() {
+                bool finite = std::all_of(b.begin(), b.end(), [](F x) {
+                    return std::isfinite(x);
+                });
+                for (size_t i = 0; i < A.rows() && finite; i++) {
+                    finite = std::all_of(A.row_data(i),
+                                         A.row_data(i) + A.cols(),
+                                         [](F x) { return std::isfinite(x); });
+                }
+                return finite;
+            });
+
+        // Os escalares convertidos para S têm o erro da conversão, arredondado
+        // para cima.
+        size_t n = P.dimensions();
+        matnxm<S> D(A.rows(), n);
+        vecn<S> d(A.rows());
+        auto& first = m_levels[0];
+        for (size_t j = 0; j < n; j++) {
+            first.columns.push_back(j);
+        }
+        for (size_t i = 0; i < A.rows(); i++) {
+            row_info<S> info = {0, 0, std::numeric_limits<S>::infinity(), i,
+                                no_row, true};
+            F error = 0;
+            auto convert = [&](F x) {
+                S y = S(x);
+                error = std::max(error, absolute(x - F(y)));
+                info.norm = std::max(info.norm, absolute(y));
+                info.unit = std::min(info.unit, lowest_bit(y));
+                info.exact_zeros &= x == 0 || y != 0;
+                return y;
+            };
+            for (size_t j = 0; j < n; j++) {
+                D.unchecked_at(i, j) = convert(A.unchecked_at(i, j));
+            }
+            d.unchecked_at(i) = convert(b.unchecked_at(i));
+
+            info.error = S(error);
+            if (F(info.error) < error) {
+                info.error = std::nextafter(info.error,
+                                            std::numeric_limits<S>::infinity());
+            }
+            check_precision(info);
+            first.info.push_back(info);
+        }
+        first.P = polyhedron<S>(std::move(D), std::move(d));
+    }
+
+    /**
+     * @brief Último nível da cadeia.
+     */
+    const level<S>& last() const { return m_levels.back(); }
+
+    /**
+     * @brief Número de sinais decididos pelo recálculo em F.
+     */
+    size_t refined_signs() const { return m_refined_signs; }
+
+    /**
+     * @brief Número de sinais decididos pelo recálculo exato.
+     */
+    size_t exact_signs() const { return m_exact_signs; }
+
+    /**
+     * @brief Determina se alguma linha tem erro grande demais para a
+     * precisão de S.
+     */
+    bool coarse() const { return m_coarse; }
+
+    /**
+     * @brief Sinal exato de um escalar de uma linha do último nível.
+     *
+     * @param i Índice da linha.
+     * @param j Índice da coluna, ou o número de colunas para o lado direito.
+     * @return int -1, 0 ou 1.
+     */
+    int sign(size_t i, size_t j) {
+        const auto& current = last();
+        size_t cols = current.columns.size();
+        S v = j < cols ? current.P.A().unchecked_at(i, j)
+                       : current.P.b().unchecked_at(i);
+        const auto& info = current.info[i];
+        int result = filtered_sign(v, info.error, info.exact_zeros);
+        if (result != 2) {
+            return result;
+        }
+
+        size_t k = m_levels.size() - 1;
+        if (screening) {
+            const auto& row = refined(k, i);
+            result = filtered_sign(row.values[j], row.info.error,
+                                   row.info.exact_zeros);
+            if (result != 2) {
+                m_refined_signs++;
+                return result;
+            }
+        }
+        m_exact_signs++;
+        return exact_row(k, i)[j].sign();
+    }
+
+    /**
+     * @brief Elimina uma coluna do último nível, adicionando um nível.
+     *
+     * @param column Coluna eliminada.
+     * @param variable Variável eliminada, para o orçamento e as
+     * estatísticas.
+     * @param resources Orçamento de recursos.
+     */
+    void eliminate(size_t column, size_t variable, const budget& resources) {
+        step_timer timer(variable, false);
+
+        std::vector<size_t> N, Z, P;
+        for (size_t i = 0; i < last().P.A().rows(); i++) {
+            int s = sign(i, column);
+            (s < 0 ? N : (s > 0 ? P : Z)).push_back(i);
+        }
+
+        const auto& source = last();
+        const auto& A = source.P.A();
+        const auto& b = source.P.b();
+        size_t n = A.cols(), rows = Z.size() + N.size() * P.size();
+        resources.check_allocation(
+            rows, budget::sum(
+                      budget::sum(budget::polyhedron_bytes<S>(A.rows(), n),
+                                  budget::polyhedron_bytes<S>(rows, n - 1)),
+                      budget::bytes(A.rows() + rows, 1, sizeof(row_info<S>))));
+
+        level<S> next;
+        next.columns = source.columns;
+        next.columns.erase(next.columns.begin() + column);
+        next.info.reserve(rows);
+
+        matnxm<S> D(rows, n - 1);
+        vecn<S> d(rows);
+
+        // Mesma ordem de `polyhedron::eliminate_column`: Z e então N × P.
+        size_t i = 0;
+        for (size_t z : Z) {
+            const S* a = A.row_data(z);
+            S* out = D.row_data(i);
+            std::copy(a, a + column, out);
+            std::copy(a + column + 1, a + n, out + column);
+            d.unchecked_at(i++) = b.unchecked_at(z);
+
+            next.info.push_back(source.info[z]);
+            next.info.back().first = z;
+            next.info.back().second = no_row;
+        }
+
+        for (size_t s : N) {
+            resources.check_time();
+            const S* a_s = A.row_data(s);
+            S np = a_s[column], b_s = b.unchecked_at(s);
+            for (size_t t : P) {
+                const S* a_t = A.row_data(t);
+                S pp = a_t[column], b_t = b.unchecked_at(t);
+
+                S* out = D.row_data(i);
+                for (size_t j = 0; j < column; j++) {
+                    out[j] = a_s[j] * pp - a_t[j] * np;
+                }
+                for (size_t j = column + 1; j < n; j++) {
+                    out[j - 1] = a_s[j] * pp - a_t[j] * np;
+                }
+                S rhs = d.unchecked_at(i++) = b_s * pp - b_t * np;
+
+                next.info.push_back(combination(source.info[s], source.info[t],
+                                                absolute(np), absolute(pp)));
+                auto& info = next.info.back();
+                info.first = s;
+                info.second = t;
+                if (info.error == 0) {
+                    continue;
+                }
+                check_precision(info);
+
+                // Um zero vindo de escalares não nulos é um cancelamento.
+                info.exact_zeros = source.info[s].exact_zeros &&
+                                   source.info[t].exact_zeros &&
+                                   (rhs != 0 || (b_s == 0 && b_t == 0));
+                for (size_t j = 0; j < n && info.exact_zeros; j++) {
+                    if (j != column) {
+                        info.exact_zeros = out[j - (j > column)] != 0 ||
+                                           (a_s[j] == 0 && a_t[j] == 0);
+                    }
+                }
+            }
+        }
+
+        m_levels.back().column = column;
+        next.P = polyhedron<S>(std::move(D), std::move(d));
+        m_levels.push_back(std::move(next));
+        m_refined.emplace_back();
+        m_exact.emplace_back();
+
+        timer.finish(N.size(), Z.size(), P.size(), rows, 0,
+                     budget::polyhedron_bytes<S>(rows, n - 1));
+    }
+
+    /**
+     * @brief Determina se a eliminação da única coluna do último nível gera
+     * uma linha 0 <= d_i com d_i < 0, sem materializar o resultado: cada
+     * combinação é descartada assim que o seu sinal é decidido.
+     *
+     * @param variable Variável eliminada, para o orçamento e as
+     * estatísticas.
+     * @param resources Orçamento de recursos.
+     * @return true se o poliedro é vazio.
+     */
+    bool eliminate_last(size_t variable, const budget& resources) {
+        step_timer timer(variable, false);
+        const auto& source = last();
+        const auto& A = source.P.A();
+        const auto& b = source.P.b();
+        internal::validate("cannot stream elimination of more than one column",
+                           [&]() { return A.cols() == 1; });
+
+        std::vector<size_t> N, Z, P;
+        bool negative = false;
+        for (size_t i = 0; i < A.rows(); i++) {
+            int s = sign(i, 0);
+            (s < 0 ? N : (s > 0 ? P : Z)).push_back(i);
+            negative |= s == 0 && sign(i, 1) < 0;
+        }
+
+        for (size_t n = 0; n < N.size() && !negative; n++) {
+            resources.check_time();
+            size_t s = N[n];
+            S np = A.unchecked_at(s, 0), b_s = b.unchecked_at(s);
+            for (size_t p = 0; p < P.size() && !negative; p++) {
+                size_t t = P[p];
+                S pp = A.unchecked_at(t, 0), b_t = b.unchecked_at(t);
+                S rhs = b_s * pp - b_t * np;
+
+                auto info = combination(source.info[s], source.info[t],
+                                        absolute(np), absolute(pp));
+                bool exact_zero = source.info[s].exact_zeros &&
+                                  source.info[t].exact_zeros &&
+                                  (rhs != 0 || (b_s == 0 && b_t == 0));
+                int sign = filtered_sign(rhs, info.error, exact_zero);
+                if (sign == 2) {
+                    sign = combination_sign(s, t, 1, 0);
+                }
+                negative = sign < 0;
+            }
+        }
+
+        timer.finish(N.size(), Z.size(), P.size(),
+                     Z.size() + N.size() * P.size(), 0, 0);
+        return negative;
+    }
+};
+
+/**
+ * @brief Teste de vazio com uma cadeia de eliminação, interrompido se a
+ * cadeia se torna imprecisa (vide `chain`).
+ */
+template <typename F, typename S>
+bool empty(chain<F, S>& steps, budget& resources) {
+    while (steps.last().columns.size() > 1 && !steps.coarse()) {
+        const auto& current = steps.last();
+        column_index<S> index(current.P.A());
+        size_t best_column = 0;
+        for (size_t j = 1; j < current.columns.size(); j++) {
+            if (index.elimination_rows(j) <
+                index.elimination_rows(best_column)) {
+                best_column = j;
+            }
+        }
+
+        size_t variable = current.columns[best_column];
+        resources.begin_step(variable);
+        steps.eliminate(best_column, variable, resources);
+    }
+    if (steps.coarse()) {
+        return false;
+    }
+
+    // O último passo não é materializado: basta encontrar uma linha
+    // 0 <= d_i com d_i < 0.
+    if (steps.last().columns.size() == 1) {
+        size_t variable = steps.last().columns[0];
+        resources.begin_step(variable);
+        return steps.eliminate_last(variable, resources);
+    }
+    for (size_t i = 0; i < steps.last().P.b().size(); i++) {
+        if (steps.sign(i, 0) < 0) {
+            return true;
+        }
+    }
+    return false;
+}
+}; // namespace internal_filtered
+
+/**
+ * @brief Eliminação de um conjunto de variáveis com decisões de sinal exatas
+ * (vide `polyhedron::eliminate`).
+ *
+ * As linhas são calculadas em ponto flutuante, cada uma com uma cota do seu
+ * erro; somente os escalares cujo sinal não é decidido pela cota são
+ * recalculados exatamente a partir das linhas de entrada. Com isso, valores
+ * próximos de zero por arredondamento não geram partições N/P espúrias. As
+ * linhas de todos os passos são mantidas até o fim da eliminação, para o
+ * recálculo.
+ *
+ * @param P Poliedro com escalares de ponto flutuante finitos.
+ * @param variables Índices das variáveis eliminadas.
+ * @param resources Orçamento de recursos.
+ * @return subspace_projection<F> A projeção, na dimensão reduzida.
+ */
+template <typename F>
+subspace_projection<F>
+filtered_eliminate(const polyhedron<F>& P, const std::vector<size_t>& variables,
+                   budget& resources) {
+    std::vector<char> eliminated(P.dimensions());
+    for (size_t v : variables) {
+        internal::validate("cannot eliminate variable out of bounds",
+                           [&]() { return v < P.dimensions(); });
+        internal::validate("cannot eliminate variable twice",
+                           [&]() { return !eliminated[v]; });
+        eliminated[v] = 1;
+    }
+
+    internal_filtered::chain<F> steps(P);
+    std::vector<size_t> pending(variables);
+    while (!pending.empty()) {
+        // A ordem é escolhida pelos sinais aproximados, como em
+        // `polyhedron::eliminate`; somente as partições são exatas.
+        const auto& current = steps.last();
+        column_index<F> index(current.P.A());
+        size_t best = 0, best_column = 0;
+        size_t best_rows = std::numeric_limits<size_t>::max();
+        for (size_t k = 0; k < pending.size(); k++) {
+            size_t column = std::lower_bound(current.columns.begin(),
+                                             current.columns.end(),
+                                             pending[k]) -
+                            current.columns.begin();
+            size_t rows = index.elimination_rows(column);
+            if (rows < best_rows) {
+                best = k;
+                best_column = column;
+                best_rows = rows;
+            }
+        }
+
+        resources.begin_step(pending[best]);
+        steps.eliminate(best_column, pending[best], resources);
+        pending.erase(pending.begin() + best);
+    }
+    return {steps.last().P, steps.last().columns};
+}
+
+template <typename F>
+subspace_projection<F>
+filtered_eliminate(const polyhedron<F>& P,
+                   const std::vector<size_t>& variables) {
+    budget unlimited;
+    return filtered_eliminate(P, variables, unlimited);
+}
+
+/**
+ * @brief Teste de vazio com decisões de sinal exatas: elimina todas as
+ * variáveis, como em `filtered_eliminate`, e decide exatamente se algum lado
+ * direito resultante é negativo. O último passo não é materializado e termina
+ * na primeira linha que prova o vazio.
+ *
+ * Diferentemente de `polyhedron::empty`, não há propagação de limites antes
+ * da eliminação, pois os limites são calculados com folgas aproximadas.
+ *
+ * @param P Poliedro com escalares de ponto flutuante finitos.
+ * @param resources Orçamento de recursos.
+ * @return true se o poliedro é vazio.
+ */
+template <typename F>
+bool filtered_empty(const polyhedron<F>& P, budget& resources) {
+    internal_filtered::chain<F> steps(P);
+    return internal_filtered::empty(steps, resources);
+}
+
+template <typename F> bool filtered_empty(const polyhedron<F>& P) {
+    budget unlimited;
+    return filtered_empty(P, unlimited);
+}
+
+/**
+ * @brief Teste de vazio com decisões de sinal exatas e as linhas geradas em
+ * precisão simples (vide `filtered_empty`).
+ *
+ * As linhas ocupam metade da memória, e as combinações processam o dobro de
+ * escalares por instrução vetorial. Os sinais que a cota de erro em precisão
+ * simples não decide são recalculados em F e, se preciso, exatamente. Se o
+ * erro acumulado em precisão simples se torna grande demais, o teste é
+ * refeito com `filtered_empty`.
+ *
+ * @param P Poliedro com escalares de ponto flutuante finitos.
+ * @param resources Orçamento de recursos.
+ * @return true se o poliedro é vazio.
+ */
+template <typename F>
+bool screened_empty(const polyhedron<F>& P, budget& resources) {
+    internal_filtered::chain<F, float> screen(P);
+    bool result = internal_filtered::empty(screen, resources);
+    if (!screen.coarse()) {
+        return result;
+    }
+    resources.reset_steps();
+    return filtered_empty(P, resources);
+}
+
+template <typename F> bool screened_empty(const polyhedron<F>& P) {
+    budget unlimited;
+    return screened_empty(P, unlimited);
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_FILTERED__
@@ -0,0 +1,497 @@
+#ifndef __POLYHEDRAL_INCLUSION__
+#define __POLYHEDRAL_INCLUSION__
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "external.hpp"
+#include "polyhedron.hpp"
+#include "projection.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Resultado de um teste de inclusão ou de equivalência de poliedros.
+ *
+ * Convertido para `bool`, indica se a relação vale.
+ */
+struct inclusion_result {
+    static constexpr size_t no_row = std::numeric_limits<size_t>::max();
+
+    // Índice da linha violada, ou `no_row` se a relação vale.
+    size_t row = no_row;
+
+    // Se a linha violada é do primeiro argumento (somente em `equivalent`);
+    // caso contrário, ela é do segundo.
+    bool first = false;
+
+    // Linhas decididas por comparação com as linhas do outro poliedro, e
+    // linhas decididas por programação linear.
+    size_t matched = 0;
+    size_t solved = 0;
+
+    explicit operator bool() const { return row == no_row; }
+};
+
+namespace internal_inclusion {
+// Quantidade de multiplicações estimada a partir da qual os programas lineares
+// são resolvidos em múltiplas threads.
+static constexpr size_t PARALLEL_WORK = size_t(1) << 22;
+
+/**
+ * @brief Tolerância padrão dos testes, relativa à magnitude de cada linha
+ * (vide `polyhedron::contains`).
+ */
+template <typename F> F default_tolerance() {
+    return std::sqrt(std::numeric_limits<F>::epsilon());
+}
+
+/**
+ * @brief Linhas não triviais de um poliedro, normalizadas (vide
+ * `internal_rows::normalize`), cada uma com os coeficientes seguidos do lado
+ * direito.
+ */
+template <typename F> struct normalized_rows {
+    size_t cols = 0;
+    std::vector<F> values;
+
+    // Índice, no poliedro, de cada linha.
+    std::vector<size_t> origin;
+
+    explicit normalized_rows(const polyhedron<F>& P) : cols(P.dimensions()) {
+        const auto& A = P.A();
+        values.resize(A.rows() * (cols + 1));
+        for (size_t i = 0; i < A.rows(); i++) {
+            // As linhas de P já são guardadas aumentadas, como [a_i | b_i].
+            F* row = values.data() + origin.size() * (cols + 1);
+            std::copy_n(A.row_data(i), cols + 1, row);
+            if (internal_rows::normalize(row, cols)) {
+                origin.push_back(i);
+            }
+        }
+        values.resize(origin.size() * (cols + 1));
+    }
+
+    size_t size() const { return origin.size(); }
+
+    const F* row(size_t k) const { return values.data() + k * (cols + 1); }
+};
+
+/**
+ * @brief Programa linear max c · x sujeito a Ax <= b, resolvido pelo dual
+ * min b · y sujeito a Aᵀy = c, y >= 0, com um simplex denso sobre as n
+ * restrições de igualdade.
+ *
+ * Os custos reduzidos do dual dependem somente de b e da base, e não de c:
+ * a base ótima de um objetivo continua dual-viável para os demais, e cada
+ * solução parte da base da anterior pelo simplex dual.
+ *
+ * A base inicial é encontrada uma só vez, com c = 0: as colunas artificiais
+ * saem da base (exceto nas restrições redundantes, quando A não tem posto n)
+ * e o simplex primal minimiza b · y sobre o cone {y >= 0 : Aᵀy = 0}. O
+ * mínimo é 0 se Ax <= b tem solução, e ilimitado caso contrário (lema de
+ * Farkas).
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class support_lp {
+  private:
+    size_t m_n = 0;
+    size_t m_m = 0;
+
+    // B⁻¹ [Aᵀ | I]: uma coluna por linha de A, seguidas de n colunas
+    // artificiais, que guardam B⁻¹.
+    matnxm<F> m_T;
+
+    // Custos b das colunas de A (as artificiais têm custo 0), e os seus
+    // custos reduzidos.
+    std::vector<F> m_cost;
+    std::vector<F> m_reduced;
+
+    // Valores das variáveis básicas (B⁻¹c) e coluna básica de cada
+    // restrição.
+    std::vector<F> m_beta;
+    std::vector<size_t> m_basis;
+
+    // Restrições cuja coluna artificial não sai da base.
+    std::vector<char> m_redundant;
+
+    bool m_empty = false;
+
+    // Módulo mínimo de um pivô, e tolerância dos testes de sinal dos valores
+    // e custos reduzidos, que acumulam erros de arredondamento dos pivôs.
+    F m_pivot_tolerance;
+    F m_tolerance;
+
+  public:
+    /**
+     * @brief Prepara o programa linear de um poliedro.
+     *
+     * @param rows Linhas normalizadas do poliedro.
+     */
+    explicit support_lp(const normalized_rows<F>& rows)
+        : m_n(rows.cols), m_m(rows.size()), m_T(m_n, m_m + m_n),
+          m_cost(m_m), m_reduced(m_m), m_beta(m_n), m_basis(m_n),
+          m_redundant(m_n),
+          m_pivot_tolerance(std::numeric_limits<F>::epsilon() * 1024),
+          m_tolerance(std::sqrt(std::numeric_limits<F>::epsilon()) / 64) {
+        for (size_t k = 0; k < m_m; k++) {
+            const F* a = rows.row(k);
+            for (size_t r = 0; r < m_n; r++) {
+                m_T.unchecked_at(r, k) = a[r];
+            }
+            m_cost[k] = m_reduced[k] = a[m_n];
+        }
+        for (size_t r = 0; r < m_n; r++) {
+            m_T.unchecked_at(r, m_m + r) = 1;
+            m_basis[r] = m_m + r;
+        }
+
+        // Retira as colunas artificiais da base. Como c = 0, todo pivô é
+        // degenerado.
+        for (size_t r = 0; r < m_n; r++) {
+            size_t best = m_m;
+            F magnitude = m_pivot_tolerance;
+            for (size_t j = 0; j < m_m; j++) {
+                F x = std::abs(m_T.unchecked_at(r, j));
+                if (x > magnitude) {
+                    best = j;
+                    magnitude = x;
+                }
+            }
+            if (best == m_m) {
+                m_redundant[r] = 1;
+            } else {
+                pivot(r, best);
+            }
+        }
+
+        // Simplex primal com a regra de Bland, que evita ciclos entre as
+        // bases degeneradas.
+        for (;;) {
+            size_t j = 0;
+            while (j < m_m && m_reduced[j] >= -m_tolerance) {
+                j++;
+            }
+            if (j == m_m) {
+                return;
+            }
+
+            size_t leave = m_n;
+            for (size_t r = 0; r < m_n; r++) {
+                if (!m_redundant[r] &&
+                    m_T.unchecked_at(r, j) > m_pivot_tolerance &&
+                    (leave == m_n || m_basis[r] < m_basis[leave])) {
+                    leave = r;
+                }
+            }
+            if (leave == m_n) {
+                m_empty = true;
+                return;
+            }
+            pivot(leave, j);
+        }
+    }
+
+    /**
+     * @brief Determina se Ax <= b não tem solução.
+     */
+    bool empty() const { return m_empty; }
+
+    /**
+     * @brief Calcula max c · x sujeito a Ax <= b, partindo da base da última
+     * chamada. Requer que Ax <= b tenha solução.
+     *
+     * @param c Objetivo, com n coordenadas.
+     * @param value Referência de saída para o valor ótimo.
+     * @return true se o máximo existe.
+     * @return false se c · x é ilimitado sobre o poliedro.
+     */
+    bool maximize(const F* c, F& value) {
+        for (size_t r = 0; r < m_n; r++) {
+            const F* inverse = m_T.row_data(r) + m_m;
+            F beta = 0;
+            for (size_t k = 0; k < m_n; k++) {
+                beta += inverse[k] * c[k];
+            }
+            m_beta[r] = beta;
+
+            // Se c não está no espaço das linhas de A, o poliedro contém
+            // uma reta não ortogonal a c.
+            if (m_redundant[r] && std::abs(beta) > m_tolerance) {
+                return false;
+            }
+        }
+
+        // Simplex dual: a linha mais negativa sai da base, até que os pivôs
+        // somem m + n; a partir daí, a regra de Bland evita ciclos.
+        for (size_t pivots = 0;; pivots++) {
+            size_t leave = m_n;
+            for (size_t r = 0; r < m_n; r++) {
+                if (m_redundant[r] || m_beta[r] >= -m_tolerance) {
+                    continue;
+                }
+                if (leave == m_n ||
+                    (pivots < m_m + m_n ? m_beta[r] < m_beta[leave]
+                                        : m_basis[r] < m_basis[leave])) {
+                    leave = r;
+                }
+            }
+            if (leave == m_n) {
+                break;
+            }
+
+            const F* row = m_T.row_data(leave);
+            size_t enter = m_m;
+            F ratio = 0;
+            for (size_t j = 0; j < m_m; j++) {
+                if (row[j] < -m_pivot_tolerance) {
+                    F candidate = std::max<F>(m_reduced[j], 0) / -row[j];
+                    if (enter == m_m || candidate < ratio) {
+                        enter = j;
+                        ratio = candidate;
+                    }
+                }
+            }
+            if (enter == m_m) {
+                // O dual não tem solução: c · x é ilimitado.
+                return false;
+            }
+            pivot(leave, enter);
+        }
+
+        value = 0;
+        for (size_t r = 0; r < m_n; r++) {
+            if (m_basis[r] < m_m) {
+                value += m_cost[m_basis[r]] * m_beta[r];
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Ponto do poliedro em que a última chamada de `maximize` atinge o
+     * máximo, dado pelos multiplicadores da base: x = B⁻ᵀ b_B.
+     *
+     * @param x Vetor de saída, com n coordenadas.
+     */
+    void point(F* x) const {
+        std::fill_n(x, m_n, F(0));
+        for (size_t r = 0; r < m_n; r++) {
+            if (m_basis[r] < m_m) {
+                const F* inverse = m_T.row_data(r) + m_m;
+                F cost = m_cost[m_basis[r]];
+                for (size_t k = 0; k < m_n; k++) {
+                    x[k] += cost * inverse[k];
+                }
+            }
+        }
+    }
+
+  private:
+    /**
+     * @brief Coloca a coluna j na base, no lugar da básica da restrição r.
+     */
+    void pivot(size_t r, size_t j) {
+        size_t width = m_m + m_n;
+        F* row = m_T.row_data(r);
+        F p = row[j];
+        for (size_t x = 0; x < width; x++) {
+            row[x] /= p;
+        }
+        row[j] = 1;
+        m_beta[r] /= p;
+
+        for (size_t k = 0; k < m_n; k++) {
+            F* other = m_T.row_data(k);
+            F f = other[j];
+            if (k == r || f == 0) {
+                continue;
+            }
+            internal_projection::combine_rows(other, F(1), row, f, width,
+                                              other);
+            other[j] = 0;
+            m_beta[k] -= f * m_beta[r];
+        }
+
+        F f = m_reduced[j];
+        if (f != 0) {
+            for (size_t x = 0; x < m_m; x++) {
+                m_reduced[x] -= f * row[x];
+            }
+            m_reduced[j] = 0;
+        }
+        m_basis[r] = j;
+    }
+};
+
+/**
+ * @brief Procura a primeira linha de Q que não contém P.
+ *
+ * Uma linha de Q é satisfeita se é trivial ou se P tem uma linha normalizada
+ * com os mesmos coeficientes e lado direito menor ou igual; as demais são
+ * decididas por max q_i · x sobre P, com um programa linear por linha.
+ */
+template <typename F>
+inclusion_result included(const polyhedron<F>& P, const polyhedron<F>& Q,
+                          F tolerance) {
+    internal::validate("cannot compare polyhedra of different dimensions",
+                       [&]() { return P.dimensions() == Q.dimensions(); });
+
+    size_t n = P.dimensions();
+    normalized_rows<F> p_rows(P), q_rows(Q);
+    inclusion_result result;
+
+    // Linhas de P em ordem lexicográfica: entre as de mesmos coeficientes, a
+    // primeira tem o menor lado direito.
+    std::vector<size_t> order(p_rows.size());
+    for (size_t k = 0; k < order.size(); k++) {
+        order[k] = k;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+        return internal_rows::less(p_rows.row(x), p_rows.row(y), n + 1);
+    });
+
+    std::vector<size_t> pending;
+    result.matched = Q.A().rows() - q_rows.size();
+    for (size_t k = 0; k < q_rows.size(); k++) {
+        const F* q = q_rows.row(k);
+        auto it = std::lower_bound(
+            order.begin(), order.end(), q, [&](size_t x, const F* row) {
+                return internal_rows::less(p_rows.row(x), row, n);
+            });
+        if (it != order.end() &&
+            internal_rows::equal(p_rows.row(*it), q, n) &&
+            p_rows.row(*it)[n] <= q[n]) {
+            result.matched++;
+        } else {
+            pending.push_back(k);
+        }
+    }
+    if (pending.empty()) {
+        return result;
+    }
+
+    support_lp<F> base(p_rows);
+    if (base.empty()) {
+        // O poliedro vazio está contido em qualquer outro.
+        result.matched += pending.size();
+        return result;
+    }
+
+    // Cada thread resolve um intervalo das linhas pendentes, em ordem, a partir
+    // de uma cópia da base inicial. Linhas posteriores à primeira violação já
+    // encontrada são ignoradas, então a linha devolvida é sempre a primeira.
+    std::atomic<size_t> first(pending.size());
+    std::atomic<size_t> solved(0);
+    auto solve = [&](size_t begin, size_t end) {
+        support_lp<F> lp(base);
+        for (size_t p = begin; p < end && p < first.load(); p++) {
+            const F* q = q_rows.row(pending[p]);
+            F value;
+            bool bounded = lp.maximize(q, value);
+            solved++;
+
+            F scale = std::max<F>(1, std::abs(q[n]));
+            if (!bounded || value > q[n] + tolerance * scale) {
+                size_t current = first.load();
+                while (p < current &&
+                       !first.compare_exchange_weak(current, p)) {
+                }
+                return;
+            }
+        }
+    };
+
+    size_t work = pending.size() * (p_rows.size() + n) * n;
+    size_t threads =
+        work < PARALLEL_WORK
+            ? 1
+            : std::min<size_t>(std::thread::hardware_concurrency(),
+                               pending.size());
+    if (threads <= 1) {
+        solve(0, pending.size());
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t w = 0; w < threads; w++) {
+            size_t begin = pending.size() * w / threads,
+                   end = pending.size() * (w + 1) / threads;
+            workers.emplace_back([&, begin, end]() { solve(begin, end); });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    result.solved = solved.load();
+    if (first.load() < pending.size()) {
+        result.row = q_rows.origin[pending[first.load()]];
+    }
+    return result;
+}
+}; // namespace internal_inclusion
+
+/**
+ * @brief Determina se um poliedro P está contido em um poliedro Q (P ⊆ Q).
+ *
+ * Os argumentos seguem a ordem da leitura "P contido em Q", inversa à de
+ * `std::includes`, em que o primeiro intervalo contém o segundo.
+ *
+ * Cada linha q_i · x <= d_i de Q é primeiro comparada com as linhas de P:
+ * após a normalização (vide `internal_rows::normalize`), basta que P tenha uma
+ * linha com os mesmos coeficientes e lado direito menor ou igual. As demais
+ * linhas são testadas por programação linear, calculando max q_i · x sobre P,
+ * com as soluções em paralelo para muitas linhas. A linha é violada se o
+ * máximo passa de d_i + t_i, onde t_i = tolerance · max(1, |d_i|) na linha
+ * normalizada, ou se não existe.
+ *
+ * @param P Poliedro contido.
+ * @param Q Poliedro que contém P.
+ * @param tolerance Tolerância relativa à magnitude de cada linha de Q.
+ * @return inclusion_result O resultado do teste, com a primeira linha de Q
+ * violada por algum ponto de P, se houver.
+ */
+template <typename F>
+inclusion_result
+contained_in(const polyhedron<F>& P, const polyhedron<F>& Q,
+             F tolerance = internal_inclusion::default_tolerance<F>()) {
+    return internal_inclusion::included(P, Q, tolerance);
+}
+
+/**
+ * @brief Determina se dois poliedros são iguais como conjuntos, testando a
+ * inclusão nos dois sentidos (vide `contained_in`).
+ *
+ * @param P Primeiro poliedro.
+ * @param Q Segundo poliedro.
+ * @param tolerance Tolerância relativa à magnitude de cada linha.
+ * @return inclusion_result O resultado do teste, com a primeira linha de Q
+ * violada por P ou, se P ⊆ Q, a primeira linha de P violada por Q.
+ */
+template <typename F>
+inclusion_result
+equivalent(const polyhedron<F>& P, const polyhedron<F>& Q,
+           F tolerance = internal_inclusion::default_tolerance<F>()) {
+    inclusion_result forward = internal_inclusion::included(P, Q, tolerance);
+    if (!forward) {
+        return forward;
+    }
+
+    inclusion_result backward = internal_inclusion::included(Q, P, tolerance);
+    backward.first = !backward;
+    backward.matched += forward.matched;
+    backward.solved += forward.solved;
+    return backward;
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_INCLUSION__
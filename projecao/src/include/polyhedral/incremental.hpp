@@ -0,0 +1,390 @@
+#ifndef __POLYHEDRAL_INCREMENTAL__
+#define __POLYHEDRAL_INCREMENTAL__
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "polyhedron.hpp"
+#include "stats.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Poliedro construído por adição de linhas, que mantém a cadeia de
+ * eliminação de Fourier-Motzkin da última consulta.
+ *
+ * A cadeia tem um nível por passo de eliminação: o nível 0 tem as linhas
+ * adicionadas e o nível k + 1 tem as linhas geradas pela eliminação de uma
+ * variável do nível k. A variável de cada passo é escolhida na primeira vez em
+ * que o passo é executado, pela mesma regra gulosa de
+ * `polyhedron::eliminate`, e não muda depois disso.
+ *
+ * As consultas (`empty`, `projection`) levam pela cadeia somente as linhas
+ * adicionadas desde a consulta anterior: em cada passo, as novas linhas com
+ * coeficiente zero na variável são copiadas, e as com coeficientes negativo e
+ * positivo são combinadas com todas as linhas de sinal oposto do nível, novas
+ * ou não. Cada nível tem as mesmas linhas (possivelmente em outra ordem) que
+ * a eliminação a partir do zero, com a mesma ordem de variáveis, geraria.
+ *
+ * `push` e `pop` formam uma pilha de pontos de retorno: `pop` remove, de todos
+ * os níveis, as linhas adicionadas ou geradas desde o `push` correspondente.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class incremental_polyhedron {
+  private:
+    /**
+     * @brief Nível da cadeia de eliminação.
+     */
+    struct level {
+        // Coordenadas originais das colunas do nível.
+        std::vector<size_t> columns;
+
+        // Linhas do nível, cada uma com `columns.size()` coeficientes
+        // seguidos do lado direito.
+        std::vector<F> rows;
+
+        // Variável eliminada no passo que sai do nível, e a sua coluna, ou
+        // `budget::no_variable` se o passo ainda não foi executado.
+        size_t variable = budget::no_variable;
+        size_t column = 0;
+
+        // Linhas já levadas ao próximo nível, e as que dentre elas têm
+        // coeficiente negativo e positivo na coluna eliminada.
+        size_t processed = 0;
+        std::vector<size_t> negative;
+        std::vector<size_t> positive;
+
+        size_t width() const { return columns.size() + 1; }
+
+        size_t size() const { return rows.size() / width(); }
+
+        const F* row(size_t i) const { return rows.data() + i * width(); }
+    };
+
+    /**
+     * @brief Tamanho de um nível em um ponto de retorno.
+     */
+    struct level_mark {
+        size_t rows;
+        size_t processed;
+        size_t negative;
+        size_t positive;
+    };
+
+    std::vector<level> m_levels;
+    std::vector<std::vector<level_mark>> m_marks;
+
+    /**
+     * @brief Escolhe a variável eliminada no passo que sai do nível k: a que
+     * gera menos linhas com as linhas atuais do nível.
+     */
+    void choose(size_t k) {
+        level& current = m_levels[k];
+        size_t cols = current.columns.size(), rows = current.size();
+
+        size_t best_rows = std::numeric_limits<size_t>::max();
+        for (size_t j = 0; j < cols; j++) {
+            size_t N = 0, P = 0;
+            for (size_t i = 0; i < rows; i++) {
+                F a = current.row(i)[j];
+                N += a < 0;
+                P += a > 0;
+            }
+            if ((rows - N - P) + N * P < best_rows) {
+                best_rows = (rows - N - P) + N * P;
+                current.column = j;
+            }
+        }
+        current.variable = current.columns[current.column];
+
+        level& next = m_levels[k + 1];
+        next.columns = current.columns;
+        next.columns.erase(next.columns.begin() + current.column);
+    }
+
+    /**
+     * @brief Leva as linhas novas do nível k ao nível k + 1.
+     */
+    void step(size_t k, budget& resources) {
+        level& current = m_levels[k];
+        if (current.variable == budget::no_variable) {
+            choose(k);
+        }
+        if (current.processed == current.size()) {
+            return;
+        }
+        level& next = m_levels[k + 1];
+        size_t column = current.column, cols = current.columns.size();
+
+        std::vector<size_t> N, Z, P;
+        for (size_t i = current.processed; i < current.size(); i++) {
+            F a = current.row(i)[column];
+            if (a < 0) {
+                N.push_back(i);
+            } else if (a > 0) {
+                P.push_back(i);
+            } else {
+                Z.push_back(i);
+            }
+        }
+
+        // Novas linhas: Z, N novas × todas as P e N antigas × P novas.
+        size_t old_N = current.negative.size(), old_P = current.positive.size();
+        size_t generated =
+            Z.size() + N.size() * (old_P + P.size()) + old_N * P.size();
+        size_t total = next.size() + generated;
+
+        resources.begin_step(current.variable);
+        step_timer timer(current.variable, false);
+        resources.check_allocation(
+            total, budget::bytes(current.size() + total, cols, sizeof(F)));
+
+        // As linhas são geradas em um buffer à parte, de forma que um
+        // orçamento excedido deixa a cadeia em um estado consistente.
+        std::vector<F> out;
+        out.reserve(generated * cols);
+        for (size_t z : Z) {
+            const F* a = current.row(z);
+            out.insert(out.end(), a, a + column);
+            out.insert(out.end(), a + column + 1, a + cols + 1);
+        }
+
+        auto combine = [&](size_t s, size_t t) {
+            const F* a_s = current.row(s);
+            const F* a_t = current.row(t);
+            F np = a_s[column], pp = a_t[column];
+            for (size_t j = 0; j <= cols; j++) {
+                if (j != column) {
+                    out.push_back(a_s[j] * pp - a_t[j] * np);
+                }
+            }
+        };
+        for (size_t s : N) {
+            resources.check_time();
+            for (size_t t : current.positive) {
+                combine(s, t);
+            }
+            for (size_t t : P) {
+                combine(s, t);
+            }
+        }
+        for (size_t s : current.negative) {
+            resources.check_time();
+            for (size_t t : P) {
+                combine(s, t);
+            }
+        }
+
+        next.rows.insert(next.rows.end(), out.begin(), out.end());
+        current.negative.insert(current.negative.end(), N.begin(), N.end());
+        current.positive.insert(current.positive.end(), P.begin(), P.end());
+        current.processed = current.size();
+
+        timer.finish(N.size(), Z.size(), P.size(), generated, 0,
+                     budget::bytes(generated, cols, sizeof(F)));
+    }
+
+    /**
+     * @brief Leva as linhas novas pelos `steps` primeiros passos da cadeia.
+     */
+    void update(size_t steps, budget& resources) {
+        for (size_t k = 0; k < steps; k++) {
+            step(k, resources);
+        }
+    }
+
+  public:
+    using scalar_type = F;
+
+    /**
+     * @brief Constrói o poliedro R^dimensions (sem linhas).
+     *
+     * @param dimensions Número de dimensões.
+     */
+    explicit incremental_polyhedron(size_t dimensions)
+        : m_levels(dimensions + 1) {
+        for (size_t j = 0; j < dimensions; j++) {
+            m_levels[0].columns.push_back(j);
+        }
+    }
+
+    /**
+     * @brief Constrói um poliedro com as linhas de P(A, b).
+     *
+     * @param P Poliedro.
+     */
+    explicit incremental_polyhedron(const polyhedron<F>& P)
+        : incremental_polyhedron(P.dimensions()) {
+        add(P);
+    }
+
+    /**
+     * @brief Número de dimensões do poliedro.
+     */
+    size_t dimensions() const { return m_levels[0].columns.size(); }
+
+    /**
+     * @brief Número de linhas adicionadas (e não removidas por `pop`).
+     */
+    size_t rows() const { return m_levels[0].size(); }
+
+    /**
+     * @brief Número de pontos de retorno na pilha.
+     */
+    size_t depth() const { return m_marks.size(); }
+
+    /**
+     * @brief Variável eliminada no passo k da cadeia, ou
+     * `budget::no_variable` se o passo ainda não foi executado.
+     */
+    size_t variable(size_t k) const { return m_levels[k].variable; }
+
+    /**
+     * @brief Adiciona uma desigualdade `lhs x <= rhs`.
+     *
+     * @param lhs Coeficientes da desigualdade.
+     * @param rhs Lado direito da desigualdade.
+     */
+    void add(const vecn<F>& lhs, F rhs) {
+        internal::validate("cannot add row of incompatible dimension",
+                           [&]() { return lhs.size() == dimensions(); });
+        add(lhs.data(), rhs);
+    }
+
+    /**
+     * @brief Adiciona uma desigualdade `lhs x <= rhs`.
+     *
+     * @param lhs Ponteiro para os `dimensions()` coeficientes da desigualdade.
+     * @param rhs Lado direito da desigualdade.
+     */
+    void add(const F* lhs, F rhs) {
+        auto& rows = m_levels[0].rows;
+        rows.insert(rows.end(), lhs, lhs + dimensions());
+        rows.push_back(rhs);
+    }
+
+    /**
+     * @brief Adiciona as linhas de um poliedro P(A, b).
+     *
+     * @param P Poliedro.
+     */
+    void add(const polyhedron<F>& P) {
+        internal::validate("cannot add rows of incompatible dimension",
+                           [&]() { return P.dimensions() == dimensions(); });
+        auto& rows = m_levels[0].rows;
+        rows.reserve(rows.size() + P.A().rows() * (dimensions() + 1));
+        for (size_t i = 0; i < P.A().rows(); i++) {
+            add(P.A().row_data(i), P.b().unchecked_at(i));
+        }
+    }
+
+    /**
+     * @brief Empilha um ponto de retorno.
+     */
+    void push() {
+        std::vector<level_mark> mark;
+        mark.reserve(m_levels.size());
+        for (const auto& current : m_levels) {
+            mark.push_back({current.size(), current.processed,
+                            current.negative.size(),
+                            current.positive.size()});
+        }
+        m_marks.push_back(std::move(mark));
+    }
+
+    /**
+     * @brief Remove as linhas adicionadas desde o último `push`, e as geradas
+     * a partir delas, e desempilha o ponto de retorno.
+     */
+    void pop() {
+        internal::validate("cannot pop without a matching push",
+                           [&]() { return !m_marks.empty(); });
+
+        const auto& mark = m_marks.back();
+        for (size_t k = 0; k < m_levels.size(); k++) {
+            level& current = m_levels[k];
+            current.rows.resize(mark[k].rows * current.width());
+            current.processed = mark[k].processed;
+            current.negative.resize(mark[k].negative);
+            current.positive.resize(mark[k].positive);
+        }
+        m_marks.pop_back();
+    }
+
+    /**
+     * @brief Poliedro P(A, b) com as linhas adicionadas.
+     */
+    polyhedron<F> system() const {
+        const level& first = m_levels[0];
+        matnxm<F> A(first.size(), dimensions());
+        vecn<F> b(first.size());
+        for (size_t i = 0; i < first.size(); i++) {
+            std::copy_n(first.row(i), dimensions(), A.row_data(i));
+            b.unchecked_at(i) = first.row(i)[dimensions()];
+        }
+        return {std::move(A), std::move(b)};
+    }
+
+    /**
+     * @brief Projeção do poliedro após os `steps` primeiros passos da cadeia
+     * de eliminação.
+     *
+     * @param steps Número de passos, no máximo `dimensions()`.
+     * @param resources Orçamento de recursos.
+     * @return subspace_projection<scalar_type> A projeção, na dimensão
+     * reduzida (vide `polyhedron::eliminate`).
+     */
+    subspace_projection<scalar_type> projection(size_t steps,
+                                                budget& resources) {
+        internal::validate("cannot eliminate more variables than dimensions",
+                           [&]() { return steps <= dimensions(); });
+        update(steps, resources);
+
+        const level& last = m_levels[steps];
+        size_t cols = last.columns.size();
+        matnxm<F> D(last.size(), cols);
+        vecn<F> d(last.size());
+        for (size_t i = 0; i < last.size(); i++) {
+            std::copy_n(last.row(i), cols, D.row_data(i));
+            d.unchecked_at(i) = last.row(i)[cols];
+        }
+        return {{std::move(D), std::move(d)}, last.columns};
+    }
+
+    subspace_projection<scalar_type> projection(size_t steps) {
+        budget unlimited;
+        return projection(steps, unlimited);
+    }
+
+    /**
+     * @brief Determina se o poliedro é vazio, levando pela cadeia de
+     * eliminação somente as linhas adicionadas desde a consulta anterior.
+     *
+     * @param resources Orçamento de recursos.
+     * @return true se o poliedro é vazio.
+     */
+    bool empty(budget& resources) {
+        update(dimensions(), resources);
+
+        // O último nível não tem colunas: o poliedro é vazio sse existe linha
+        // 0 <= d_i com d_i negativo.
+        const auto& d = m_levels.back().rows;
+        return std::any_of(d.begin(), d.end(), [](F x) { return x < 0; });
+    }
+
+    bool empty() {
+        budget unlimited;
+        return empty(unlimited);
+    }
+};
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_INCREMENTAL__
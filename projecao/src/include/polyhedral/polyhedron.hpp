@@ -0,0 +1,585 @@
+#ifndef __POLYHEDRAL_POLYHEDRON__
+#define __POLYHEDRAL_POLYHEDRON__
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "column_index.hpp"
+#include "stats.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+template <typename F> class projection;
+template <typename F> struct subspace_projection;
+
+/**
+ * @brief Método usado no cálculo de projeções.
+ */
+enum class projection_engine {
+    // Escolhe o método pelo custo estimado.
+    AUTO,
+
+    // Eliminação de Fourier-Motzkin.
+    FOURIER_MOTZKIN,
+
+    // Conversão para geradores pelo método da dupla descrição (vide
+    // `double_description`).
+    DOUBLE_DESCRIPTION,
+};
+
+/**
+ * @brief Classe de poliedros sobre um corpo F.
+ *
+ * As linhas de P(A, b) são armazenadas aumentadas, como [a_i | b_i]: o vetor b
+ * ocupa a primeira coluna reservada de A (vide `matnxm::reserved_column`), de
+ * forma que cada linha é contígua, alinhada e preenchida até a largura dos
+ * registradores vetoriais. Um passo de Fourier-Motzkin combina duas linhas,
+ * incluindo o lado direito, em um só laço.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class polyhedron {
+  private:
+    matnxm<F> m_A;
+
+  public:
+    using scalar_type = F;
+
+    polyhedron() : m_A(0, 0, 1) {}
+
+    polyhedron(polyhedron&& other) = default;
+    polyhedron& operator=(polyhedron&& other) = default;
+
+    polyhedron(const polyhedron& other) = default;
+    polyhedron& operator=(const polyhedron& other) = default;
+
+    /**
+     * @brief Constrói um poliedro P(A, b) copiando uma matriz A e um vetor b
+     * dados.
+     *
+     * @param A Matriz A da definição do poliedro.
+     * @param b Vetor b da definição do poliedro.
+     */
+    polyhedron(const matnxm<scalar_type>& A, const vecn<scalar_type>& b)
+        : m_A(A.rows(), A.cols(), 1) {
+        internal::validate("cannot create polyhedron from matrix and "
+                           "vector of incompatible dimensions",
+                           [&]() { return A.rows() == b.size(); });
+
+        for (size_t i = 0; i < A.rows(); i++) {
+            std::copy_n(A.row_data(i), A.cols(), m_A.row_data(i));
+        }
+        m_A.reserved_column(0) = b;
+    }
+
+    /**
+     * @brief Constrói um poliedro P(A, b) movendo uma matriz A e um vetor b
+     * dados. A matriz é copiada apenas se o preenchimento das suas linhas não
+     * tiver espaço para b.
+     *
+     * @param A Matriz A da definição do poliedro.
+     * @param b Vetor b da definição do poliedro.
+     */
+    polyhedron(matnxm<scalar_type>&& A, vecn<scalar_type>&& b) {
+        internal::validate("cannot create polyhedron from matrix and "
+                           "vector of incompatible dimensions",
+                           [&]() { return A.rows() == b.size(); });
+
+        if (A.stride() > A.cols()) {
+            m_A = std::move(A);
+            m_A.reserved_column(0) = b;
+        } else {
+            *this = polyhedron(static_cast<const matnxm<scalar_type>&>(A), b);
+        }
+    }
+
+    /**
+     * @brief Constrói um poliedro a partir das suas linhas aumentadas
+     * [a_i | b_i], sem cópias.
+     *
+     * @param rows Matriz A com b na sua primeira coluna reservada.
+     * @return polyhedron<scalar_type> O poliedro P(A, b).
+     */
+    static polyhedron augmented(matnxm<scalar_type>&& rows) {
+        internal::validate("cannot create polyhedron from matrix without "
+                           "reserved column",
+                           [&]() { return rows.stride() > rows.cols(); });
+
+        polyhedron result;
+        result.m_A = std::move(rows);
+        return result;
+    }
+
+    /**
+     * @brief Número de dimensões do espaço vetorial no qual o poliedro existe.
+     *
+     * @return size_t O número de dimensões do espaço vetorial no qual o
+     * poliedro existe.
+     */
+    size_t dimensions() const { return m_A.cols(); }
+
+    /**
+     * @brief Vista mutável da matriz A de um poliedro: as células e as linhas
+     * podem ser alteradas, mas a matriz não pode ser substituída nem
+     * redimensionada, já que o preenchimento das suas linhas guarda b.
+     */
+    class matrix_view {
+      private:
+        matnxm<scalar_type>& m_A;
+
+        explicit matrix_view(matnxm<scalar_type>& A) : m_A(A) {}
+        friend class polyhedron;
+
+      public:
+        using row_type = typename matnxm<scalar_type>::row_type;
+        using column_type = typename matnxm<scalar_type>::column_type;
+
+        matrix_view(const matrix_view&) = default;
+        matrix_view& operator=(const matrix_view&) = delete;
+
+        size_t rows() const { return m_A.rows(); }
+        size_t cols() const { return m_A.cols(); }
+        size_t stride() const { return m_A.stride(); }
+
+        scalar_type* row_data(size_t row) const { return m_A.row_data(row); }
+
+        scalar_type& unchecked_at(size_t row, size_t col) const {
+            return m_A.unchecked_at(row, col);
+        }
+
+        scalar_type& operator()(size_t row, size_t col) const {
+            return m_A(row, col);
+        }
+
+        row_type operator()(size_t row, all_t) const { return m_A(row, all); }
+
+        column_type operator()(all_t, size_t col) const {
+            return m_A(all, col);
+        }
+
+        row_type operator[](size_t row) const { return m_A[row]; }
+
+        /**
+         * @brief A matriz, para leitura.
+         */
+        operator const matnxm<scalar_type>&() const { return m_A; }
+    };
+
+    /**
+     * @brief Matriz A da definição do poliedro. As células podem ser
+     * alteradas, mas não as dimensões da matriz, cujo preenchimento guarda b.
+     *
+     * @return matrix_view Uma vista mutável da matriz da definição do
+     * poliedro.
+     */
+    matrix_view A() { return matrix_view(m_A); }
+
+    /**
+     * @brief Matriz A da definição do poliedro.
+     *
+     * @return const matnxm<scalar_type>& Uma referência imutável para a matriz
+     * A da definição do poliedro.
+     */
+    const matnxm<scalar_type>& A() const { return m_A; }
+
+    /**
+     * @brief Vetor b da definição do poliedro.
+     *
+     * @return column_type Uma vista do vetor b da definição do poliedro, que
+     * é a coluna reservada de A.
+     */
+    typename matnxm<scalar_type>::column_type b() {
+        return m_A.reserved_column(0);
+    }
+
+    /**
+     * @brief Vetor b da definição do poliedro.
+     *
+     * @return const_column_type Uma vista imutável do vetor b da definição do
+     * poliedro, que é a coluna reservada de A.
+     */
+    typename matnxm<scalar_type>::const_column_type b() const {
+        return m_A.reserved_column(0);
+    }
+
+    /**
+     * @brief Calcula o poliedro de projeção P(D, d) do poliedro na direção
+     * dada.
+     *
+     * @param direction Vetor que indica a direção da projeção.
+     * @return polyhedron<scalar_type> Um poliedro P(D, d) tal que a projeção
+     * de P(A, b) na direção dada sobre qualquer conjunto H é P(D, d) ∩ H.
+     */
+    polyhedron<scalar_type> project(const vecn<scalar_type>& direction) const;
+
+    /**
+     * @brief Calcula o poliedro de projeção P(D, d) do poliedro na direção
+     * dada, respeitando um orçamento de recursos.
+     *
+     * Por Fourier-Motzkin, P(D, d) tem |Z| + |N| × |P| linhas, em geral
+     * redundantes. Pelo método da dupla descrição, P(D, d) tem apenas as
+     * facetas da projeção, mas o custo depende do número de vértices de
+     * P(A, b), que não é conhecido de antemão. Com `projection_engine::AUTO`,
+     * a dupla descrição é tentada quando Fourier-Motzkin geraria muitas linhas,
+     * limitada ao custo estimado de Fourier-Motzkin, que é usado caso o limite
+     * seja excedido.
+     *
+     * @param direction Vetor que indica a direção da projeção.
+     * @param resources Orçamento de recursos.
+     * @param engine Método da projeção.
+     * @return polyhedron<scalar_type> Um poliedro P(D, d) tal que a projeção
+     * de P(A, b) na direção dada sobre qualquer conjunto H é P(D, d) ∩ H.
+     */
+    polyhedron<scalar_type>
+    project(const vecn<scalar_type>& direction, budget& resources,
+            projection_engine engine = projection_engine::AUTO) const;
+
+    /**
+     * @brief Colapsa uma dimensão do poliedro, projetando-o na direção da
+     * dimensão (a.k.a. Eliminação de Fourier–Motzkin).
+     *
+     * @param coord Índice da dimensão a ser colapsada.
+     * @return polyhedron<scalar_type> Um poliedro P(D, d) equivalente a P(A, b)
+     * com a dimensão dada colapsada em 0.
+     */
+    polyhedron<scalar_type> collapse_dimension(size_t coord) const {
+        budget unlimited;
+        return collapse_dimension(coord, unlimited);
+    }
+
+    /**
+     * @brief Colapsa uma dimensão do poliedro, respeitando um orçamento de
+     * recursos.
+     *
+     * @param coord Índice da dimensão a ser colapsada.
+     * @param resources Orçamento de recursos.
+     * @return polyhedron<scalar_type> Um poliedro P(D, d) equivalente a P(A, b)
+     * com a dimensão dada colapsada em 0.
+     */
+    polyhedron<scalar_type> collapse_dimension(size_t coord,
+                                               budget& resources) const {
+        internal::validate("cannot project polyhedron on direction with "
+                           "incompatible dimensions",
+                           [&]() { return coord < dimensions(); });
+
+        vecn<scalar_type> direction(dimensions());
+        direction[coord] = 1;
+
+        resources.begin_step(coord);
+        return eliminate(direction, coord, resources);
+    }
+
+    /**
+     * @brief Elimina um conjunto de variáveis por Fourier-Motzkin, projetando
+     * o poliedro no subespaço das demais coordenadas.
+     *
+     * @param variables Índices das variáveis a serem eliminadas.
+     * @return subspace_projection<scalar_type> A projeção, na dimensão
+     * reduzida (vide `eliminate(const std::vector<size_t>&, budget&)`).
+     */
+    subspace_projection<scalar_type>
+    eliminate(const std::vector<size_t>& variables) const {
+        budget unlimited;
+        return eliminate(variables, unlimited);
+    }
+
+    /**
+     * @brief Elimina um conjunto de variáveis por Fourier-Motzkin, respeitando
+     * um orçamento de recursos.
+     *
+     * Diferente de `collapse_dimension`, a coluna de cada variável eliminada
+     * é removida do resultado do passo, de forma que as linhas ficam mais
+     * curtas a cada passo. As variáveis são eliminadas em ordem gulosa: a cada
+     * passo, a que gera menos linhas (|Z| + |N| × |P|).
+     *
+     * @param variables Índices das variáveis a serem eliminadas.
+     * @param resources Orçamento de recursos.
+     * @return subspace_projection<scalar_type> A projeção, na dimensão
+     * reduzida, com o índice original de cada coluna restante.
+     */
+    subspace_projection<scalar_type>
+    eliminate(const std::vector<size_t>& variables, budget& resources) const;
+
+    /**
+     * @brief Projeta o poliedro no subespaço de um conjunto de coordenadas.
+     *
+     * @param keep Índices das coordenadas mantidas.
+     * @return subspace_projection<scalar_type> A projeção, na dimensão
+     * reduzida (vide `eliminate`).
+     */
+    subspace_projection<scalar_type>
+    project_onto(const std::vector<size_t>& keep) const {
+        budget unlimited;
+        return project_onto(keep, unlimited);
+    }
+
+    /**
+     * @brief Projeta o poliedro no subespaço de um conjunto de coordenadas,
+     * respeitando um orçamento de recursos, eliminando as demais (vide
+     * `eliminate`).
+     *
+     * @param keep Índices das coordenadas mantidas.
+     * @param resources Orçamento de recursos.
+     * @return subspace_projection<scalar_type> A projeção, na dimensão
+     * reduzida, com as coordenadas mantidas em ordem crescente.
+     */
+    subspace_projection<scalar_type>
+    project_onto(const std::vector<size_t>& keep, budget& resources) const;
+
+    /**
+     * @brief Determina se o poliedro é vazio.
+     *
+     * @return true se o poliedro for vazio.
+     * @return false caso contrário.
+     */
+    bool empty() const {
+        budget unlimited;
+        return empty(unlimited);
+    }
+
+    /**
+     * @brief Determina se o poliedro é vazio, respeitando um orçamento de
+     * recursos.
+     *
+     * @param resources Orçamento de recursos.
+     * @return true se o poliedro for vazio.
+     * @return false caso contrário.
+     */
+    bool empty(budget& resources) const;
+
+    /**
+     * @brief Determina se um ponto pertence ao poliedro.
+     *
+     * A linha i é considerada satisfeita se a_i · x <= b_i + t_i, onde
+     * t_i = tolerance · max(1, |a_i1|, ..., |a_in|, |b_i|).
+     *
+     * @param point Ponto.
+     * @param tolerance Tolerância relativa à magnitude de cada linha.
+     * @return true se o ponto satisfaz toda linha de P(A, b).
+     * @return false caso contrário.
+     */
+    bool contains(const vecn<scalar_type>& point,
+                  scalar_type tolerance = 0) const {
+        internal::validate(
+            "cannot test membership of point with incompatible dimensions",
+            [&]() { return point.size() == dimensions(); });
+
+        const scalar_type* x = point.data();
+        for (size_t i = 0; i < m_A.rows(); i++) {
+            const scalar_type* a = m_A.row_data(i);
+            scalar_type dot = 0;
+            for (size_t j = 0; j < m_A.cols(); j++) {
+                dot += a[j] * x[j];
+            }
+            if (dot > threshold(i, tolerance)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Determina quais pontos de um lote pertencem ao poliedro.
+     *
+     * Os pontos são processados em blocos: cada linha de A é aplicada a todos
+     * os pontos do bloco que ainda não violaram nenhuma linha, e um ponto deixa
+     * de ser testado assim que viola uma linha. Lotes grandes são divididos
+     * entre threads.
+     *
+     * @param points Matriz cujas linhas são os pontos a serem testados.
+     * @param tolerance Tolerância relativa à magnitude de cada linha (vide
+     * `contains`).
+     * @return std::vector<bool> Mapa de bits tal que o bit k indica se o ponto
+     * na linha k de `points` pertence ao poliedro.
+     */
+    std::vector<bool> contains_many(const matnxm<scalar_type>& points,
+                                    scalar_type tolerance = 0) const {
+        internal::validate(
+            "cannot test membership of points with incompatible dimensions",
+            [&]() { return points.cols() == dimensions(); });
+
+        vecn<scalar_type> thresholds(m_A.rows());
+        for (size_t i = 0; i < m_A.rows(); i++) {
+            thresholds.unchecked_at(i) = threshold(i, tolerance);
+        }
+
+        // Cada ponto escreve em um byte próprio, então as threads nunca
+        // escrevem na mesma palavra de memória.
+        std::vector<char> inside(points.rows());
+
+        size_t blocks = (points.rows() + CONTAINS_BLOCK - 1) / CONTAINS_BLOCK;
+        size_t work = points.rows() * m_A.rows() * m_A.cols();
+        size_t threads =
+            work < CONTAINS_PARALLEL_WORK
+                ? 1
+                : std::min<size_t>(std::thread::hardware_concurrency(), blocks);
+
+        if (threads <= 1) {
+            contains_blocks(points, thresholds, 0, blocks, inside);
+        } else {
+            std::vector<std::thread> workers;
+            workers.reserve(threads);
+            for (size_t w = 0; w < threads; w++) {
+                size_t first = blocks * w / threads,
+                       last = blocks * (w + 1) / threads;
+                workers.emplace_back([&, first, last]() {
+                    contains_blocks(points, thresholds, first, last, inside);
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        return std::vector<bool>(inside.begin(), inside.end());
+    }
+
+  private:
+    /**
+     * @brief Passo de eliminação de Fourier-Motzkin na direção dada,
+     * registrando suas estatísticas (vide `stats_recorder`).
+     *
+     * @param direction Vetor que indica a direção da projeção.
+     * @param variable Índice da variável eliminada, ou `budget::no_variable`.
+     * @param resources Orçamento de recursos.
+     */
+    polyhedron<scalar_type> eliminate(const vecn<scalar_type>& direction,
+                                      size_t variable,
+                                      const budget& resources) const;
+
+    /**
+     * @brief Passo de eliminação de Fourier-Motzkin de uma coluna, que é
+     * removida do resultado.
+     *
+     * @param column Índice da coluna eliminada.
+     * @param variable Índice original da variável eliminada.
+     * @param resources Orçamento de recursos.
+     * @param index Índice de sinais das colunas do poliedro.
+     * @param next Referência de saída para o índice do resultado, ou nulo se
+     * ele não for necessário.
+     */
+    polyhedron<scalar_type>
+    eliminate_column(size_t column, size_t variable, const budget& resources,
+                     const column_index<scalar_type>& index,
+                     column_index<scalar_type>* next) const;
+
+    // Custo estimado de Fourier-Motzkin (em escalares calculados) a partir do
+    // qual `project` tenta a dupla descrição.
+    static constexpr size_t GENERATORS_MIN_WORK = size_t(1) << 16;
+
+    // Número de pontos testados juntos por `contains_many`.
+    static constexpr size_t CONTAINS_BLOCK = 64;
+
+    // Quantidade de multiplicações a partir da qual `contains_many` usa
+    // múltiplas threads.
+    static constexpr size_t CONTAINS_PARALLEL_WORK = size_t(1) << 22;
+
+    /**
+     * @brief Limite superior b_i + t_i aceito para a_i · x (vide `contains`).
+     */
+    scalar_type threshold(size_t i, scalar_type tolerance) const {
+        scalar_type rhs = m_A.row_data(i)[m_A.cols()];
+        if (tolerance == 0) {
+            return rhs;
+        }
+
+        auto abs = [](scalar_type x) { return x < 0 ? -x : x; };
+        const scalar_type* a = m_A.row_data(i);
+        scalar_type scale = std::max<scalar_type>(1, abs(rhs));
+        for (size_t j = 0; j < m_A.cols(); j++) {
+            scale = std::max(scale, abs(a[j]));
+        }
+        return rhs + tolerance * scale;
+    }
+
+    /**
+     * @brief Testa os pontos dos blocos [first, last) de `contains_many`.
+     */
+    void contains_blocks(const matnxm<scalar_type>& points,
+                         const vecn<scalar_type>& thresholds, size_t first,
+                         size_t last, std::vector<char>& inside) const {
+        std::vector<size_t> alive;
+        alive.reserve(CONTAINS_BLOCK);
+
+        for (size_t block = first; block < last; block++) {
+            size_t begin = block * CONTAINS_BLOCK,
+                   end = std::min(points.rows(), begin + CONTAINS_BLOCK);
+
+            alive.clear();
+            for (size_t k = begin; k < end; k++) {
+                alive.push_back(k);
+            }
+
+            // Aplica cada linha de A aos pontos do bloco que ainda não violaram
+            // nenhuma linha, removendo os que a violam.
+            for (size_t i = 0; i < m_A.rows() && !alive.empty(); i++) {
+                const scalar_type* a = m_A.row_data(i);
+                for (size_t p = 0; p < alive.size();) {
+                    const scalar_type* x = points.row_data(alive[p]);
+                    scalar_type dot = 0;
+                    for (size_t j = 0; j < m_A.cols(); j++) {
+                        dot += a[j] * x[j];
+                    }
+                    if (dot > thresholds.unchecked_at(i)) {
+                        alive[p] = alive.back();
+                        alive.pop_back();
+                    } else {
+                        p++;
+                    }
+                }
+            }
+
+            for (size_t k : alive) {
+                inside[k] = 1;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Projeção de um poliedro no subespaço de um conjunto de coordenadas:
+ * um poliedro na dimensão reduzida e o índice, no poliedro original, de cada
+ * uma das suas colunas.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> struct subspace_projection {
+    polyhedron<F> P;
+    std::vector<size_t> columns;
+
+    /**
+     * @brief Poliedro equivalente na dimensão original, com colunas nulas nas
+     * coordenadas eliminadas (como o resultado de `collapse_dimension`).
+     *
+     * @param dimensions Número de dimensões do poliedro original.
+     */
+    polyhedron<F> expand(size_t dimensions) const {
+        internal::validate("cannot expand projection to fewer dimensions",
+                           [&]() {
+                               return columns.empty() ||
+                                      columns.back() < dimensions;
+                           });
+
+        const auto& A = P.A();
+        matnxm<F> expanded(A.rows(), dimensions, 1);
+        for (size_t i = 0; i < A.rows(); i++) {
+            const F* a = A.row_data(i);
+            F* out = expanded.row_data(i);
+            for (size_t j = 0; j < columns.size(); j++) {
+                out[columns[j]] = a[j];
+            }
+            out[dimensions] = a[A.cols()];
+        }
+        return polyhedron<F>::augmented(std::move(expanded));
+    }
+};
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_POLYHEDRON__
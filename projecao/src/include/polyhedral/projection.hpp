@@ -0,0 +1,742 @@
+#ifndef __POLYHEDRAL_PROJECTION__
+#define __POLYHEDRAL_PROJECTION__
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "bounds.hpp"
+#include "budget.hpp"
+#include "double_description.hpp"
+#include "polyhedron.hpp"
+#include "stats.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+namespace internal_projection {
+static constexpr size_t no_axis = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief Determina se uma direção é um múltiplo de um vetor da base canônica.
+ *
+ * @return size_t O índice da única coordenada não nula da direção, ou
+ * `no_axis` se houver mais de uma (ou nenhuma).
+ */
+template <typename F> size_t axis(const vecn<F>& direction) {
+    size_t result = no_axis;
+    for (size_t j = 0; j < direction.size(); j++) {
+        if (direction.unchecked_at(j) != 0) {
+            if (result != no_axis) {
+                return no_axis;
+            }
+            result = j;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Produtos internos das linhas de A com uma direção. Se a direção é
+ * um múltiplo de e_j, somente a coluna j é lida.
+ *
+ * @param visit Função chamada com o índice de cada linha e o seu produto
+ * interno com a direção.
+ */
+template <typename F, typename Visitor>
+void for_each_dot(const matnxm<F>& A, const vecn<F>& direction,
+                  Visitor visit) {
+    size_t j = axis(direction);
+    if (j != no_axis) {
+        F c = direction.unchecked_at(j);
+        for (size_t i = 0; i < A.rows(); i++) {
+            visit(i, A.unchecked_at(i, j) * c);
+        }
+        return;
+    }
+
+    const F* c = direction.data();
+    for (size_t i = 0; i < A.rows(); i++) {
+        const F* a = A.row_data(i);
+        F dot = 0;
+        for (size_t k = 0; k < A.cols(); k++) {
+            dot += a[k] * c[k];
+        }
+        visit(i, dot);
+    }
+}
+
+/**
+ * @brief Combinação s · sc - t · tc de dois trechos de linhas aumentadas
+ * [a | b], escrita em `out`. Com as linhas alinhadas e preenchidas (vide
+ * `polyhedron`), o lado direito é calculado no mesmo laço que os coeficientes.
+ *
+ * @param width Número de escalares combinados.
+ */
+template <typename F>
+void combine_rows(const F* s, F sc, const F* t, F tc, size_t width, F* out) {
+    for (size_t j = 0; j < width; j++) {
+        out[j] = s[j] * sc - t[j] * tc;
+    }
+}
+}; // namespace internal_projection
+
+/**
+ * @brief Projeção implícita de um poliedro P(A, b) em uma direção.
+ *
+ * Armazena apenas A, b, a direção e a partição das linhas de A em N, Z e P. As
+ * |Z| + |N| × |P| linhas do poliedro de projeção P(D, d) são calculadas sob
+ * demanda, de forma que a memória usada é linear no tamanho de P(A, b).
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class projection {
+  public:
+    using scalar_type = F;
+
+    /**
+     * @brief Desigualdade linear `lhs x <= rhs` do poliedro de projeção.
+     */
+    struct inequality {
+        vecn<scalar_type> lhs;
+        scalar_type rhs;
+    };
+
+    /**
+     * @brief Iterador sobre as linhas do poliedro de projeção.
+     *
+     * Cada linha é calculada ao ser acessada, em um buffer do próprio
+     * iterador.
+     */
+    class const_iterator {
+      private:
+        const projection* m_projection;
+        size_t m_index;
+        mutable inequality m_current;
+        mutable size_t m_loaded;
+
+        const_iterator(const projection* owner, size_t index)
+            : m_projection(owner), m_index(index),
+              m_current{vecn<scalar_type>(owner->dimensions()), 0},
+              m_loaded(std::numeric_limits<size_t>::max()) {}
+        friend class projection;
+
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = inequality;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const inequality*;
+        using reference = const inequality&;
+
+        /**
+         * @brief Índice da linha atual no poliedro de projeção.
+         *
+         * @return size_t O índice da linha atual.
+         */
+        size_t index() const { return m_index; }
+
+        reference operator*() const {
+            if (m_loaded != m_index) {
+                m_projection->row(m_index, m_current.lhs, m_current.rhs);
+                m_loaded = m_index;
+            }
+            return m_current;
+        }
+
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            m_index++;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous(*this);
+            m_index++;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return m_index != other.m_index;
+        }
+    };
+
+  private:
+    polyhedron<scalar_type> m_source;
+    vecn<scalar_type> m_direction;
+
+    // Produto interno de cada linha de A com a direção.
+    vecn<scalar_type> m_dots;
+
+    std::vector<size_t> m_N, m_Z, m_P;
+
+  public:
+    projection() = delete;
+
+    projection(projection&& other) = default;
+    projection& operator=(projection&& other) = default;
+
+    projection(const projection& other) = default;
+    projection& operator=(const projection& other) = default;
+
+    /**
+     * @brief Constrói a projeção de um poliedro em uma direção, copiando o
+     * poliedro.
+     *
+     * @param source Poliedro P(A, b) a ser projetado.
+     * @param direction Vetor que indica a direção da projeção.
+     */
+    projection(const polyhedron<scalar_type>& source,
+               const vecn<scalar_type>& direction)
+        : projection(polyhedron<scalar_type>(source), direction) {}
+
+    /**
+     * @brief Constrói a projeção de um poliedro em uma direção, movendo o
+     * poliedro.
+     *
+     * @param source Poliedro P(A, b) a ser projetado.
+     * @param direction Vetor que indica a direção da projeção.
+     */
+    projection(polyhedron<scalar_type>&& source,
+               const vecn<scalar_type>& direction)
+        : m_source(std::move(source)), m_direction(direction) {
+        internal::validate(
+            "cannot project polyhedron on direction with "
+            "incompatible dimensions",
+            [&]() { return m_source.dimensions() == direction.size(); });
+
+        partition();
+    }
+
+    /**
+     * @brief Poliedro P(A, b) sendo projetado.
+     *
+     * @return const polyhedron<scalar_type>& Uma referência imutável para o
+     * poliedro original.
+     */
+    const polyhedron<scalar_type>& source() const { return m_source; }
+
+    /**
+     * @brief Direção da projeção.
+     *
+     * @return const vecn<scalar_type>& Uma referência imutável para o vetor de
+     * direção.
+     */
+    const vecn<scalar_type>& direction() const { return m_direction; }
+
+    /**
+     * @brief Linhas de A cujo produto interno com a direção é negativo.
+     *
+     * @return const std::vector<size_t>& Índices das linhas, em ordem.
+     */
+    const std::vector<size_t>& negative() const { return m_N; }
+
+    /**
+     * @brief Linhas de A cujo produto interno com a direção é zero.
+     *
+     * @return const std::vector<size_t>& Índices das linhas, em ordem.
+     */
+    const std::vector<size_t>& zero() const { return m_Z; }
+
+    /**
+     * @brief Linhas de A cujo produto interno com a direção é positivo.
+     *
+     * @return const std::vector<size_t>& Índices das linhas, em ordem.
+     */
+    const std::vector<size_t>& positive() const { return m_P; }
+
+    /**
+     * @brief Produtos internos das linhas de A com a direção da projeção.
+     *
+     * @return const vecn<scalar_type>& Um produto interno por linha de A.
+     */
+    const vecn<scalar_type>& dots() const { return m_dots; }
+
+    /**
+     * @brief Número de dimensões do espaço vetorial no qual a projeção existe.
+     *
+     * @return size_t O número de colunas de D.
+     */
+    size_t dimensions() const { return m_source.dimensions(); }
+
+    /**
+     * @brief Número de linhas do poliedro de projeção.
+     *
+     * @return size_t |Z| + |N| × |P|.
+     */
+    size_t rows() const { return m_Z.size() + m_N.size() * m_P.size(); }
+
+    /**
+     * @brief Calcula uma linha do poliedro de projeção.
+     *
+     * As linhas seguem a mesma ordem de `materialize`: primeiro as linhas de
+     * Z, e então os pares de N × P em ordem lexicográfica.
+     *
+     * @tparam Row Tipo de vetor ou linha de matriz de saída.
+     *
+     * @param index Índice da linha, em [0, rows()).
+     * @param lhs Vetor de saída para a linha de D, de tamanho dimensions().
+     * @param rhs Referência de saída para a coordenada de d.
+     */
+    template <typename Row>
+    void row(size_t index, Row&& lhs, scalar_type& rhs) const {
+        internal::validate("projection row index out of bounds",
+                           [&]() { return index < rows(); });
+
+        if (index < m_Z.size()) {
+            copy(m_Z[index], lhs, rhs);
+            return;
+        }
+
+        index -= m_Z.size();
+        combine(m_N[index / m_P.size()], m_P[index % m_P.size()], lhs, rhs);
+    }
+
+    /**
+     * @brief Calcula uma linha do poliedro de projeção.
+     *
+     * @param index Índice da linha, em [0, rows()).
+     * @return inequality A desigualdade correspondente à linha.
+     */
+    inequality operator[](size_t index) const {
+        inequality result{vecn<scalar_type>(dimensions()), 0};
+        row(index, result.lhs, result.rhs);
+        return result;
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+
+    const_iterator end() const { return const_iterator(this, rows()); }
+
+    /**
+     * @brief Determina se um ponto pertence ao poliedro de projeção.
+     *
+     * Custa O((|Z| + |N| + |P|) n), sem calcular as linhas de N × P.
+     *
+     * @param point Ponto.
+     * @return true se D point <= d.
+     * @return false caso contrário.
+     */
+    bool contains(const vecn<scalar_type>& point) const {
+        internal::validate(
+            "cannot test membership of point with incompatible dimensions",
+            [&]() { return point.size() == dimensions(); });
+
+        for (size_t z : m_Z) {
+            if (slack(z, point) > 0) {
+                return false;
+            }
+        }
+
+        if (m_N.empty() || m_P.empty()) {
+            return true;
+        }
+
+        // Para s ∈ N e t ∈ P, faça q_s = -(a_s · c) > 0, q_t = a_t · c > 0 e
+        // r_i = a_i · x - b_i. A linha (s, t) é satisfeita por x sse
+        //  q_t r_s + q_s r_t <= 0  <=>  r_s / q_s + r_t / q_t <= 0,
+        // então x satisfaz todas as linhas de N × P sse satisfaz a linha do par
+        // que maximiza cada uma das frações.
+        //
+        // As frações são comparadas por produto cruzado, evitando divisões
+        // (que seriam truncadas para escalares inteiros).
+        scalar_type r_s = slack(m_N[0], point), q_s = -m_dots[m_N[0]];
+        for (size_t j = 1; j < m_N.size(); j++) {
+            scalar_type r = slack(m_N[j], point), q = -m_dots[m_N[j]];
+            if (r * q_s > r_s * q) {
+                r_s = r;
+                q_s = q;
+            }
+        }
+
+        scalar_type r_t = slack(m_P[0], point), q_t = m_dots[m_P[0]];
+        for (size_t k = 1; k < m_P.size(); k++) {
+            scalar_type r = slack(m_P[k], point), q = m_dots[m_P[k]];
+            if (r * q_t > r_t * q) {
+                r_t = r;
+                q_t = q;
+            }
+        }
+
+        return q_t * r_s + q_s * r_t <= 0;
+    }
+
+    /**
+     * @brief Calcula explicitamente o poliedro de projeção P(D, d).
+     *
+     * @return polyhedron<scalar_type> Um poliedro P(D, d) tal que a projeção
+     * de P(A, b) na direção dada sobre qualquer conjunto H é P(D, d) ∩ H.
+     */
+    polyhedron<scalar_type> materialize() const {
+        budget unlimited;
+        return materialize(unlimited);
+    }
+
+    /**
+     * @brief Calcula explicitamente o poliedro de projeção P(D, d), respeitando
+     * um orçamento de recursos.
+     *
+     * O orçamento é verificado antes da alocação de P(D, d) e periodicamente
+     * durante o cálculo das linhas.
+     *
+     * @param resources Orçamento de recursos.
+     * @return polyhedron<scalar_type> Um poliedro P(D, d) tal que a projeção
+     * de P(A, b) na direção dada sobre qualquer conjunto H é P(D, d) ∩ H.
+     */
+    polyhedron<scalar_type> materialize(const budget& resources) const {
+        // Como N, P e Z são disjuntos, r = |Z ∪ (N × P)| = |Z| + |N| × |P|.
+        size_t r = rows();
+
+        resources.check_allocation(
+            r, budget::sum(budget::polyhedron_bytes<scalar_type>(
+                               m_source.A().rows(), dimensions()),
+                           budget::polyhedron_bytes<scalar_type>(
+                               r, dimensions())));
+
+        // As linhas de P(D, d) são escritas já aumentadas, como [D_i | d_i].
+        size_t n = dimensions();
+        const auto& A = m_source.A();
+        matnxm<scalar_type> D(r, n, 1);
+
+        // Faça R = {0, ..., r - 1}.
+        //
+        // Construímos uma bijeção implícita p : R -> Z ∪ (N × P) tal que
+        //  p(0...|Z|-1) = Z (em ordem)
+        //  p(|Z|...r-1) = N × P (em ordem lexicográfica)
+        //
+        // Os laços abaixo naturalmente iteram Z ∪ (N × P) na ordem induzida
+        // por p.
+
+        for (size_t i = 0; i < m_Z.size(); i++) {
+            std::copy_n(A.row_data(m_Z[i]), n + 1, D.row_data(i));
+        }
+
+        for (size_t j = 0, i = m_Z.size(); j < m_N.size(); j++) {
+            resources.check_time();
+            size_t s = m_N[j];
+            scalar_type np = m_dots.unchecked_at(s);
+            for (size_t k = 0; k < m_P.size(); k++, i++) {
+                size_t t = m_P[k];
+                internal_projection::combine_rows(
+                    A.row_data(s), m_dots.unchecked_at(t), A.row_data(t), np,
+                    n + 1, D.row_data(i));
+            }
+        }
+
+        return polyhedron<scalar_type>::augmented(std::move(D));
+    }
+
+  private:
+    /**
+     * @brief Particiona o conjunto de linhas da matriz A baseado no sinal do
+     * produto interno com a direção da projeção, guardando os produtos
+     * internos calculados.
+     */
+    void partition() {
+        const auto& A = source().A();
+
+        m_dots = vecn<scalar_type>(A.rows());
+        m_N.reserve(A.rows());
+        m_Z.reserve(A.rows());
+        m_P.reserve(A.rows());
+
+        internal_projection::for_each_dot(
+            A, m_direction, [&](size_t i, scalar_type dot) {
+                m_dots.unchecked_at(i) = dot;
+                if (dot < 0) {
+                    m_N.push_back(i);
+                } else if (dot > 0) {
+                    m_P.push_back(i);
+                } else {
+                    m_Z.push_back(i);
+                }
+            });
+    }
+
+    /**
+     * @brief Copia uma linha de P(A, b) para a saída.
+     */
+    template <typename Row>
+    void copy(size_t z, Row&& lhs, scalar_type& rhs) const {
+        lhs = m_source.A()[z];
+        rhs = m_source.b().unchecked_at(z);
+    }
+
+    /**
+     * @brief Combina as linhas s ∈ N e t ∈ P de P(A, b) em uma linha de P(D, d)
+     * ortogonal à direção da projeção.
+     */
+    template <typename Row>
+    void combine(size_t s, size_t t, Row&& lhs, scalar_type& rhs) const {
+        const auto& A = m_source.A();
+        const auto& b = m_source.b();
+
+        // A expressão é avaliada em um único laço, escrevendo diretamente na
+        // linha de saída.
+        scalar_type np = m_dots.unchecked_at(s), pp = m_dots.unchecked_at(t);
+        lhs = A[s] * pp - A[t] * np;
+        rhs = b.unchecked_at(s) * pp - b.unchecked_at(t) * np;
+    }
+
+    /**
+     * @brief Folga a_i · x - b_i de uma linha de P(A, b) em um ponto.
+     */
+    scalar_type slack(size_t i, const vecn<scalar_type>& point) const {
+        const auto& A = m_source.A();
+        const scalar_type *a = A.row_data(i), *x = point.data();
+
+        scalar_type result = 0;
+        for (size_t j = 0; j < A.cols(); j++) {
+            result += a[j] * x[j];
+        }
+        return result - m_source.b().unchecked_at(i);
+    }
+};
+
+template <typename F>
+polyhedron<F> polyhedron<F>::project(const vecn<F>& direction) const {
+    budget unlimited;
+    return project(direction, unlimited);
+}
+
+template <typename F>
+polyhedron<F> polyhedron<F>::project(const vecn<F>& direction,
+                                     budget& resources,
+                                     projection_engine engine) const {
+    internal::validate("cannot project polyhedron on direction with "
+                       "incompatible dimensions",
+                       [&]() { return dimensions() == direction.size(); });
+
+    resources.begin_step(budget::no_variable);
+    if (engine == projection_engine::FOURIER_MOTZKIN) {
+        return eliminate(direction, budget::no_variable, resources);
+    }
+
+    // Tamanhos da partição de Fourier-Motzkin, para a estimativa de custo e
+    // as estatísticas.
+    size_t negative = 0, zero = 0, positive = 0;
+    internal_projection::for_each_dot(m_A, direction, [&](size_t, F dot) {
+        negative += dot < 0;
+        positive += dot > 0;
+        zero += dot == 0;
+    });
+    size_t fm_rows = zero + negative * positive;
+    size_t fm_work = budget::bytes(fm_rows, dimensions() + 1, 1);
+
+    size_t work_limit = 0;
+    if (engine == projection_engine::AUTO) {
+        if (fm_work < GENERATORS_MIN_WORK) {
+            return eliminate(direction, budget::no_variable, resources);
+        }
+        work_limit = fm_work;
+    }
+
+    step_timer timer(budget::no_variable, false);
+    polyhedron<F> result;
+    if (!try_project_generators(*this, direction, resources, work_limit,
+                                result)) {
+        return eliminate(direction, budget::no_variable, resources);
+    }
+
+    size_t rows = result.A().rows();
+    timer.finish(negative, zero, positive, rows,
+                 fm_rows > rows ? fm_rows - rows : 0,
+                 budget::polyhedron_bytes<F>(rows, dimensions()));
+    return result;
+}
+
+template <typename F>
+polyhedron<F> polyhedron<F>::eliminate(const vecn<F>& direction,
+                                       size_t variable,
+                                       const budget& resources) const {
+    step_timer timer(variable, false);
+
+    projection<F> step(*this, direction);
+    polyhedron<F> result = step.materialize(resources);
+
+    timer.finish(step.negative().size(), step.zero().size(),
+                 step.positive().size(), step.rows(), 0,
+                 budget::polyhedron_bytes<F>(step.rows(), dimensions()));
+    return result;
+}
+
+template <typename F>
+polyhedron<F>
+polyhedron<F>::eliminate_column(size_t column, size_t variable,
+                                const budget& resources,
+                                const column_index<F>& index,
+                                column_index<F>* next) const {
+    step_timer timer(variable, false);
+
+    // A partição vem do índice, sem ler a coluna.
+    const std::vector<size_t>& N = index.negative(column);
+    const std::vector<size_t>& P = index.positive(column);
+    std::vector<size_t> Z;
+    index.zero(column, Z);
+
+    // O resultado tem n - 1 colunas em D e uma em d, escritas juntas nas
+    // linhas aumentadas [D_i | d_i].
+    size_t n = dimensions(), rows = Z.size() + N.size() * P.size();
+    resources.check_allocation(
+        rows, budget::sum(budget::polyhedron_bytes<F>(m_A.rows(), n),
+                          budget::polyhedron_bytes<F>(rows, n - 1)));
+
+    matnxm<F> D(rows, n - 1, 1);
+
+    // Mesma ordem de `projection::materialize`: Z e então N × P. As linhas de
+    // entrada têm n + 1 escalares; o trecho depois da coluna eliminada inclui
+    // o lado direito.
+    size_t i = 0;
+    for (size_t z : Z) {
+        const F* a = m_A.row_data(z);
+        F* out = D.row_data(i++);
+        std::copy(a, a + column, out);
+        std::copy(a + column + 1, a + n + 1, out + column);
+    }
+
+    for (size_t s : N) {
+        resources.check_time();
+        const F* a_s = m_A.row_data(s);
+        F np = a_s[column];
+        for (size_t t : P) {
+            const F* a_t = m_A.row_data(t);
+            F pp = a_t[column];
+            F* out = D.row_data(i++);
+            internal_projection::combine_rows(a_s, pp, a_t, np, column, out);
+            internal_projection::combine_rows(a_s + column + 1, pp,
+                                              a_t + column + 1, np, n - column,
+                                              out + column);
+        }
+    }
+
+    // O índice do resultado é construído depois das linhas, para não
+    // atrasar o laço de N × P.
+    if (next != nullptr) {
+        next->reset(n - 1);
+        for (size_t r = 0; r < rows; r++) {
+            next->append(D.row_data(r));
+        }
+    }
+
+    timer.finish(N.size(), Z.size(), P.size(), rows, 0,
+                 budget::polyhedron_bytes<F>(rows, n - 1));
+    return polyhedron<F>::augmented(std::move(D));
+}
+
+template <typename F>
+subspace_projection<F>
+polyhedron<F>::eliminate(const std::vector<size_t>& variables,
+                         budget& resources) const {
+    std::vector<char> eliminated(dimensions());
+    for (size_t v : variables) {
+        internal::validate("cannot eliminate variable out of bounds",
+                           [&]() { return v < dimensions(); });
+        internal::validate("cannot eliminate variable twice",
+                           [&]() { return !eliminated[v]; });
+        eliminated[v] = 1;
+    }
+
+    subspace_projection<F> result;
+    for (size_t j = 0; j < dimensions(); j++) {
+        result.columns.push_back(j);
+    }
+
+    const polyhedron<F>* current = this;
+    std::vector<size_t> pending(variables);
+    column_index<F> index, next;
+    if (!pending.empty()) {
+        index = column_index<F>(m_A);
+    }
+
+    while (!pending.empty()) {
+        // Escolha gulosa: a variável cuja eliminação gera menos linhas.
+        size_t best = 0, best_column = 0;
+        size_t best_rows = std::numeric_limits<size_t>::max();
+        for (size_t k = 0; k < pending.size(); k++) {
+            size_t column = std::lower_bound(result.columns.begin(),
+                                             result.columns.end(),
+                                             pending[k]) -
+                            result.columns.begin();
+            size_t rows = index.elimination_rows(column);
+            if (rows < best_rows) {
+                best = k;
+                best_column = column;
+                best_rows = rows;
+            }
+        }
+
+        size_t variable = pending[best];
+        resources.begin_step(variable);
+        // O índice do resultado só é necessário se houver outro passo.
+        result.P = current->eliminate_column(best_column, variable, resources,
+                                             index,
+                                             pending.size() > 1 ? &next
+                                                                : nullptr);
+        std::swap(index, next);
+        current = &result.P;
+
+        result.columns.erase(result.columns.begin() + best_column);
+        pending.erase(pending.begin() + best);
+    }
+
+    if (current == this) {
+        result.P = *this;
+    }
+    return result;
+}
+
+template <typename F>
+subspace_projection<F>
+polyhedron<F>::project_onto(const std::vector<size_t>& keep,
+                            budget& resources) const {
+    std::vector<char> kept(dimensions());
+    for (size_t j : keep) {
+        internal::validate("cannot keep coordinate out of bounds",
+                           [&]() { return j < dimensions(); });
+        kept[j] = 1;
+    }
+
+    std::vector<size_t> variables;
+    for (size_t j = 0; j < dimensions(); j++) {
+        if (!kept[j]) {
+            variables.push_back(j);
+        }
+    }
+    return eliminate(variables, resources);
+}
+
+template <typename F> bool polyhedron<F>::empty(budget& resources) const {
+    // A propagação de limites prova o vazio de muitos poliedros sem
+    // eliminação; caso contrário, os limites encontrados substituem as linhas
+    // redundantes sobre eles.
+    auto bounds = propagate_bounds(*this, resources);
+    if (bounds.infeasible) {
+        return true;
+    }
+    polyhedron<F> bounded = apply_bounds(*this, bounds);
+
+    // Eliminamos todas as variáveis do poliedro por Fourier-Motzkin, o que
+    // resulta em um poliedro P(D, d) sem colunas em D, isto é, com D = 0.
+    std::vector<size_t> variables(dimensions());
+    for (size_t j = 0; j < variables.size(); j++) {
+        variables[j] = j;
+    }
+    auto projection = bounded.eliminate(variables, resources);
+
+    // Como D = 0, o poliedro é vazio sse existe coordenada negativa em d.
+    const auto& d = projection.P.b();
+    return std::any_of(d.begin(), d.end(), [](F x) { return x < 0; });
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_PROJECTION__
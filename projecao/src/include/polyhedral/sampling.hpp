@@ -0,0 +1,384 @@
+#ifndef __POLYHEDRAL_SAMPLING__
+#define __POLYHEDRAL_SAMPLING__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "inclusion.hpp"
+#include "polyhedron.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Opções da amostragem uniforme de pontos de um poliedro.
+ */
+struct sampling_options {
+    // Número de cadeias independentes, cada uma em uma thread. Se zero, usa
+    // uma cadeia por processador.
+    size_t chains = 0;
+
+    // Passos descartados no início de cada cadeia.
+    size_t burn_in = 1000;
+
+    // Passos entre amostras consecutivas de uma cadeia. Se zero, usa o número
+    // de dimensões do poliedro.
+    size_t thinning = 0;
+
+    // Se verdadeiro, as direções são os eixos coordenados (coordinate
+    // hit-and-run); caso contrário, direções uniformes na esfera.
+    bool coordinate = true;
+
+    // Número de pontos entregues ao destino de uma vez.
+    size_t batch = 1024;
+
+    // Semente dos geradores pseudoaleatórios das cadeias.
+    std::uint64_t seed = 1;
+};
+
+/**
+ * @brief Classe para um erro de amostragem (poliedro vazio, sem interior ou
+ * ilimitado).
+ */
+class sampling_error : public std::runtime_error {
+  public:
+    explicit sampling_error(const std::string& message)
+        : std::runtime_error("sampling error: " + message) {}
+};
+
+namespace internal_sampling {
+// Passos entre recálculos das folgas b - Ax, que corrigem o erro acumulado
+// pelas atualizações incrementais.
+static constexpr size_t REFRESH_STEPS = 1024;
+
+/**
+ * @brief Centro de Chebyshev de um poliedro limitado: o centro da maior bola
+ * contida em P(A, b), pelo programa linear max t sujeito a
+ * a_i · x + ||a_i|| t <= b_i e t <= 1.
+ *
+ * Esse programa é sempre viável (t não tem limite inferior), então o vazio de
+ * P é testado antes, pelo programa linear das próprias linhas de P.
+ *
+ * @return vecn<F> Um ponto no interior do poliedro.
+ */
+template <typename F> vecn<F> interior_point(const polyhedron<F>& P) {
+    size_t n = P.dimensions();
+    const auto& A = P.A();
+
+    if (internal_inclusion::support_lp<F>(
+            internal_inclusion::normalized_rows<F>(P))
+            .empty()) {
+        throw sampling_error("polyhedron is empty");
+    }
+
+    matnxm<F> S(A.rows() + 1, n + 1, 1);
+    for (size_t i = 0; i < A.rows(); i++) {
+        const F* a = A.row_data(i);
+        F* s = S.row_data(i);
+        F norm = 0;
+        for (size_t j = 0; j < n; j++) {
+            s[j] = a[j];
+            norm += a[j] * a[j];
+        }
+        s[n] = std::sqrt(norm);
+        s[n + 1] = a[n];
+    }
+    S.unchecked_at(A.rows(), n) = 1;
+    S.row_data(A.rows())[n + 1] = 1;
+
+    internal_inclusion::normalized_rows<F> rows(
+        polyhedron<F>::augmented(std::move(S)));
+    internal_inclusion::support_lp<F> lp(rows);
+
+    std::vector<F> objective(n + 1), center(n + 1);
+    objective[n] = 1;
+    F radius;
+    if (!lp.maximize(objective.data(), radius) || !(radius > 0)) {
+        throw sampling_error("polyhedron has empty interior");
+    }
+    lp.point(center.data());
+
+    vecn<F> x(n);
+    std::copy_n(center.begin(), n, x.begin());
+    return x;
+}
+
+/**
+ * @brief Cadeia de hit-and-run sobre P(A, b).
+ *
+ * A cadeia mantém o ponto x e as folgas s = b - Ax. Em cada passo, o ponto se
+ * move para um ponto uniforme do segmento de reta x + t d contido no
+ * poliedro: com v = Ad, o segmento é dado por t v_i <= s_i, e as folgas são
+ * atualizadas por s -= t v, sem recalcular Ax. Com as direções dos eixos,
+ * v é uma coluna de A, guardada contígua na transposta, e o passo custa O(m);
+ * com direções arbitrárias, o cálculo de v custa O(mn).
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class hit_and_run {
+  private:
+    const polyhedron<F>& m_P;
+    const matnxm<F>& m_AT;
+    bool m_coordinate;
+
+    std::vector<F> m_x;
+    std::vector<F> m_slack;
+    std::vector<F> m_direction;
+    std::vector<F> m_image;
+    size_t m_steps = 0;
+
+    std::mt19937_64 m_rng;
+    std::normal_distribution<F> m_normal;
+
+  public:
+    /**
+     * @param P Poliedro.
+     * @param AT Transposta da matriz A do poliedro.
+     * @param start Ponto inicial, no interior do poliedro.
+     * @param coordinate Se verdadeiro, usa as direções dos eixos.
+     * @param seed Semente comum às cadeias.
+     * @param chain Índice da cadeia, que distingue o seu gerador
+     * pseudoaleatório dos das demais.
+     */
+    hit_and_run(const polyhedron<F>& P, const matnxm<F>& AT,
+                const vecn<F>& start, bool coordinate, std::uint64_t seed,
+                size_t chain)
+        : m_P(P), m_AT(AT), m_coordinate(coordinate),
+          m_x(start.begin(), start.end()), m_slack(P.A().rows()),
+          m_direction(P.dimensions()), m_image(P.A().rows()) {
+        std::seed_seq sequence{std::uint32_t(seed), std::uint32_t(seed >> 32),
+                               std::uint32_t(chain)};
+        m_rng.seed(sequence);
+        refresh();
+    }
+
+    /**
+     * @brief Ponto atual da cadeia.
+     */
+    const F* point() const { return m_x.data(); }
+
+    /**
+     * @brief Avança a cadeia um passo.
+     */
+    void step() {
+        size_t m = m_slack.size(), n = m_x.size();
+        const F* v;
+        size_t axis = 0;
+        if (m_coordinate) {
+            axis = std::uniform_int_distribution<size_t>(0, n - 1)(m_rng);
+            v = m_AT.row_data(axis);
+        } else {
+            direction();
+            const auto& A = m_P.A();
+            for (size_t i = 0; i < m; i++) {
+                const F* a = A.row_data(i);
+                F dot = 0;
+                for (size_t j = 0; j < n; j++) {
+                    dot += a[j] * m_direction[j];
+                }
+                m_image[i] = dot;
+            }
+            v = m_image.data();
+        }
+
+        // Extremos do segmento: t <= s_i / v_i se v_i > 0, e t >= s_i / v_i
+        // se v_i < 0. Folgas negativas (por arredondamento) contam como zero.
+        F infinity = std::numeric_limits<F>::infinity();
+        F lower = -infinity, upper = infinity;
+        const F* s = m_slack.data();
+        for (size_t i = 0; i < m; i++) {
+            F slack = std::max<F>(s[i], 0);
+            if (v[i] > 0) {
+                upper = std::min(upper, slack / v[i]);
+            } else if (v[i] < 0) {
+                lower = std::max(lower, slack / v[i]);
+            }
+        }
+        if (lower == -infinity || upper == infinity) {
+            throw sampling_error("polyhedron is unbounded");
+        }
+
+        F t = std::uniform_real_distribution<F>(lower, upper)(m_rng);
+        F* slack = m_slack.data();
+        for (size_t i = 0; i < m; i++) {
+            slack[i] -= t * v[i];
+        }
+        if (m_coordinate) {
+            m_x[axis] += t;
+        } else {
+            for (size_t j = 0; j < n; j++) {
+                m_x[j] += t * m_direction[j];
+            }
+        }
+
+        if (++m_steps % REFRESH_STEPS == 0) {
+            refresh();
+        }
+    }
+
+  private:
+    /**
+     * @brief Sorteia uma direção uniforme na esfera unitária.
+     */
+    void direction() {
+        F norm = 0;
+        while (norm == 0) {
+            for (auto& d : m_direction) {
+                d = m_normal(m_rng);
+                norm += d * d;
+            }
+        }
+        norm = std::sqrt(norm);
+        for (auto& d : m_direction) {
+            d /= norm;
+        }
+    }
+
+    /**
+     * @brief Recalcula as folgas b - Ax.
+     */
+    void refresh() {
+        const auto& A = m_P.A();
+        size_t n = m_x.size();
+        for (size_t i = 0; i < A.rows(); i++) {
+            const F* a = A.row_data(i);
+            F dot = 0;
+            for (size_t j = 0; j < n; j++) {
+                dot += a[j] * m_x[j];
+            }
+            m_slack[i] = a[n] - dot;
+        }
+    }
+};
+}; // namespace internal_sampling
+
+/**
+ * @brief Amostra pontos uniformemente distribuídos em um poliedro limitado e
+ * com interior não vazio, por hit-and-run (vide
+ * `internal_sampling::hit_and_run`).
+ *
+ * As cadeias partem do centro de Chebyshev do poliedro e rodam em threads
+ * próprias, com sementes derivadas de `options.seed`. Cada cadeia descarta os
+ * primeiros `burn_in` passos e guarda um ponto a cada `thinning` passos; os
+ * pontos são entregues ao destino em lotes de até `batch` pontos, uma chamada
+ * por vez, mas sem ordem definida entre as cadeias.
+ *
+ * @tparam Sink Função chamada com um ponteiro para os pontos do lote (um após o
+ * outro, cada um com `P.dimensions()` coordenadas) e o seu número de pontos.
+ *
+ * @param P Poliedro.
+ * @param count Número de pontos.
+ * @param sink Destino dos pontos.
+ * @param options Opções da amostragem.
+ */
+template <typename F, typename Sink>
+void sample(const polyhedron<F>& P, size_t count, Sink&& sink,
+            const sampling_options& options = {}) {
+    internal::validate("cannot sample polyhedron without dimensions",
+                       [&]() { return P.dimensions() > 0; });
+
+    size_t n = P.dimensions();
+    vecn<F> start = internal_sampling::interior_point(P);
+    matnxm<F> AT = P.A().T();
+
+    size_t chains = options.chains;
+    if (chains == 0) {
+        chains = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    chains = std::max<size_t>(1, std::min(chains, count));
+    size_t thinning = options.thinning == 0 ? n : options.thinning;
+    size_t batch = std::max<size_t>(1, options.batch);
+
+    std::mutex lock;
+    std::exception_ptr error;
+    auto run = [&](size_t chain, size_t points) {
+        try {
+            internal_sampling::hit_and_run<F> walk(
+                P, AT, start, options.coordinate, options.seed, chain);
+            for (size_t k = 0; k < options.burn_in; k++) {
+                walk.step();
+            }
+
+            std::vector<F> buffer(std::min(batch, points) * n);
+            size_t filled = 0;
+            for (size_t p = 0; p < points; p++) {
+                for (size_t k = 0; k < thinning; k++) {
+                    walk.step();
+                }
+                std::copy_n(walk.point(), n, buffer.data() + filled * n);
+                if (++filled * n == buffer.size() || p + 1 == points) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (error) {
+                        return;
+                    }
+                    sink(static_cast<const F*>(buffer.data()), filled);
+                    filled = 0;
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    if (chains == 1) {
+        run(0, count);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(chains);
+        for (size_t c = 0; c < chains; c++) {
+            size_t points = count * (c + 1) / chains - count * c / chains;
+            workers.emplace_back([&, c, points]() { run(c, points); });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Amostra pontos uniformemente distribuídos em um poliedro (vide
+ * `sample(const polyhedron<F>&, size_t, Sink&&, const sampling_options&)`).
+ *
+ * @param P Poliedro.
+ * @param count Número de pontos.
+ * @param options Opções da amostragem.
+ * @return matnxm<F> Matriz com um ponto por linha.
+ */
+template <typename F>
+matnxm<F> sample_points(const polyhedron<F>& P, size_t count,
+                        const sampling_options& options = {}) {
+    matnxm<F> points(count, P.dimensions());
+    size_t rows = 0;
+    sample(
+        P, count,
+        [&](const F* batch, size_t size) {
+            for (size_t k = 0; k < size; k++, rows++) {
+                std::copy_n(batch + k * P.dimensions(), P.dimensions(),
+                            points.row_data(rows));
+            }
+        },
+        options);
+    return points;
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_SAMPLING__
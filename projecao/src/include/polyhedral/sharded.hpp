@@ -0,0 +1,628 @@
+#ifndef __POLYHEDRAL_SHARDED__
+#define __POLYHEDRAL_SHARDED__
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <internal.hpp>
+#include <io/binary.hpp>
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "column_index.hpp"
+#include "external.hpp"
+#include "polyhedron.hpp"
+#include "stats.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Opções da eliminação distribuída entre processos.
+ */
+struct sharded_options {
+    // Número de processos de trabalho (0 para um por processador).
+    size_t processes = 0;
+};
+
+/**
+ * @brief Classe para um erro de memória compartilhada ou de um processo de
+ * trabalho.
+ */
+class shard_error : public std::runtime_error {
+  public:
+    explicit shard_error(const std::string& message)
+        : std::runtime_error("sharded elimination error: " + message) {}
+};
+
+/**
+ * @brief Segmento de memória compartilhada POSIX.
+ *
+ * O nome do segmento é removido assim que ele é criado, de forma que a
+ * memória é liberada quando o último mapeamento é desfeito. O mapeamento é
+ * herdado pelos processos criados com `fork`.
+ */
+class shared_segment {
+  private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+
+  public:
+    shared_segment() = default;
+
+    shared_segment(const shared_segment&) = delete;
+    shared_segment& operator=(const shared_segment&) = delete;
+
+    shared_segment(shared_segment&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    shared_segment& operator=(shared_segment&& other) noexcept {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    /**
+     * @brief Cria e mapeia um segmento.
+     *
+     * @param size Tamanho do segmento, em bytes (no mínimo 1).
+     */
+    explicit shared_segment(size_t size) : m_size(std::max<size_t>(size, 1)) {
+        static std::atomic<unsigned> counter(0);
+        std::string name = "/combpol-" + std::to_string(::getpid()) + "-" +
+                           std::to_string(counter++);
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            throw shard_error("cannot create shared memory segment " + name);
+        }
+        ::shm_unlink(name.c_str());
+
+        if (::ftruncate(fd, off_t(m_size)) != 0) {
+            ::close(fd);
+            throw shard_error("cannot allocate " + std::to_string(m_size) +
+                              " bytes of shared memory");
+        }
+        m_data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+        ::close(fd);
+        if (m_data == MAP_FAILED) {
+            m_data = nullptr;
+            throw shard_error("cannot map shared memory segment");
+        }
+    }
+
+    ~shared_segment() {
+        if (m_data != nullptr) {
+            ::munmap(m_data, m_size);
+        }
+    }
+
+    void* data() const { return m_data; }
+
+    size_t size() const { return m_size; }
+};
+
+namespace internal_sharded {
+// Número mínimo de pares N × P por processo; passos menores são feitos no
+// próprio processo.
+static constexpr std::uint64_t MIN_SHARD_PAIRS = std::uint64_t(1) << 16;
+
+// Situação de uma tarefa, no campo `reserved` do cabeçalho da sua saída.
+static constexpr std::uint32_t SHARD_DONE = 1;
+static constexpr std::uint32_t SHARD_TIMEOUT = 2;
+
+/**
+ * @brief Tarefa de um processo de trabalho: os pares (s, t) ∈ N × P de
+ * índices em [first, last), numerados como em `polyhedron::eliminate_column`
+ * (s varia mais lentamente).
+ *
+ * Uma tarefa depende apenas do poliedro de entrada no formato binário, da
+ * direção e do intervalo, e produz um poliedro no formato binário; o mesmo
+ * protocolo pode ser usado com outros meios de transporte que não a memória
+ * compartilhada.
+ */
+struct shard_task {
+    std::uint64_t first;
+    std::uint64_t last;
+};
+
+/**
+ * @brief Tamanho, em bytes, de um poliedro no formato binário.
+ */
+template <typename F> size_t binary_size(size_t rows, size_t cols) {
+    return sizeof(io::binary::header) + rows * (cols + 1) * sizeof(F);
+}
+
+inline io::binary::header& header_of(void* data) {
+    return *static_cast<io::binary::header*>(data);
+}
+
+inline const io::binary::header& header_of(const void* data) {
+    return *static_cast<const io::binary::header*>(data);
+}
+
+template <typename F> F* rows_of(void* data) {
+    return reinterpret_cast<F*>(static_cast<char*>(data) +
+                                sizeof(io::binary::header));
+}
+
+template <typename F> const F* rows_of(const void* data) {
+    return reinterpret_cast<const F*>(static_cast<const char*>(data) +
+                                      sizeof(io::binary::header));
+}
+
+template <typename F> void write_header(void* data, size_t rows, size_t cols) {
+    auto& h = header_of(data);
+    std::memcpy(h.magic, io::binary::MAGIC, sizeof(h.magic));
+    h.version = io::binary::VERSION;
+    h.scalar_size = sizeof(F);
+    h.reserved = 0;
+    h.rows = rows;
+    h.cols = cols;
+}
+
+/**
+ * @brief Particiona as linhas de um poliedro no formato binário pelo sinal do
+ * produto interno com a direção.
+ *
+ * @param dots Produtos internos de saída, um por linha.
+ */
+template <typename F>
+void partition(const void* input, const vecn<F>& direction,
+               std::vector<F>& dots, std::vector<size_t>& N,
+               std::vector<size_t>& Z, std::vector<size_t>& P) {
+    const auto& h = header_of(input);
+    const F* rows = rows_of<F>(input);
+    const F* c = direction.data();
+    size_t width = h.cols + 1;
+
+    dots.resize(h.rows);
+    for (size_t i = 0; i < h.rows; i++) {
+        const F* a = rows + i * width;
+        F dot = 0;
+        for (size_t j = 0; j < h.cols; j++) {
+            dot += a[j] * c[j];
+        }
+        dots[i] = dot;
+        (dot < 0 ? N : (dot > 0 ? P : Z)).push_back(i);
+    }
+}
+
+/**
+ * @brief Ordena linhas contíguas in-place e remove duplicatas.
+ *
+ * @return size_t O número de linhas distintas, no início do buffer.
+ */
+template <typename F> size_t sort_unique(F* rows, size_t count, size_t width) {
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return internal_rows::less(rows + a * width, rows + b * width, width);
+    });
+
+    // Aplica a permutação seguindo os seus ciclos, com uma linha auxiliar:
+    // a linha i recebe a linha order[i].
+    std::vector<F> saved(width);
+    for (size_t i = 0; i < count; i++) {
+        if (order[i] == i) {
+            continue;
+        }
+        std::copy(rows + i * width, rows + (i + 1) * width, saved.begin());
+        size_t j = i;
+        while (order[j] != i) {
+            size_t k = order[j];
+            std::copy(rows + k * width, rows + (k + 1) * width,
+                      rows + j * width);
+            order[j] = j;
+            j = k;
+        }
+        std::copy(saved.begin(), saved.end(), rows + j * width);
+        order[j] = j;
+    }
+
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique == 0 || !internal_rows::equal(rows + i * width,
+                                                 rows + (unique - 1) * width,
+                                                 width)) {
+            if (i != unique) {
+                std::copy(rows + i * width, rows + (i + 1) * width,
+                          rows + unique * width);
+            }
+            unique++;
+        }
+    }
+    return unique;
+}
+
+/**
+ * @brief Executa uma tarefa: gera as linhas dos pares do intervalo,
+ * normalizadas (vide `internal_rows::normalize`), e as escreve ordenadas e
+ * sem duplicatas no formato binário.
+ *
+ * @param input Poliedro de entrada no formato binário.
+ * @param direction Direção da projeção.
+ * @param task Intervalo de pares.
+ * @param output Memória com `binary_size<F>(task.last - task.first, cols)`
+ * bytes. Em caso de sucesso, o campo `reserved` do cabeçalho é `SHARD_DONE`.
+ * @param resources Orçamento de recursos (apenas o tempo é verificado).
+ */
+template <typename F>
+void run_shard(const void* input, const vecn<F>& direction, shard_task task,
+               void* output, const budget& resources) {
+    std::vector<F> dots;
+    std::vector<size_t> N, Z, P;
+    partition(input, direction, dots, N, Z, P);
+
+    size_t cols = header_of(input).cols, width = cols + 1;
+    const F* rows = rows_of<F>(input);
+    F* out = rows_of<F>(output);
+
+    size_t count = 0;
+    for (std::uint64_t q = task.first; q < task.last; q++) {
+        if (q == task.first || q % P.size() == 0) {
+            resources.check_time();
+        }
+
+        size_t s = N[q / P.size()], t = P[q % P.size()];
+        const F* a_s = rows + s * width;
+        const F* a_t = rows + t * width;
+        F np = dots[s], pp = dots[t];
+
+        F* row = out + count * width;
+        for (size_t j = 0; j < width; j++) {
+            row[j] = a_s[j] * pp - a_t[j] * np;
+        }
+        count += internal_rows::normalize(row, cols);
+    }
+
+    write_header<F>(output, sort_unique(out, count, width), cols);
+    header_of(output).reserved = SHARD_DONE;
+}
+
+/**
+ * @brief Processos de trabalho criados com `fork`. Os processos que ainda
+ * não terminaram quando o grupo é destruído são interrompidos.
+ */
+class worker_group {
+  private:
+    std::vector<pid_t> m_pids;
+
+  public:
+    worker_group() = default;
+
+    worker_group(const worker_group&) = delete;
+    worker_group& operator=(const worker_group&) = delete;
+
+    ~worker_group() {
+        for (pid_t pid : m_pids) {
+            ::kill(pid, SIGKILL);
+            ::waitpid(pid, nullptr, 0);
+        }
+    }
+
+    /**
+     * @brief Executa uma função em um novo processo, que termina quando ela
+     * retorna. O processo não retorna ao chamador, e qualquer exceção não
+     * tratada pela função o termina com status diferente de zero.
+     */
+    template <typename Function> void spawn(Function&& function) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            throw shard_error("cannot create worker process");
+        }
+        if (pid == 0) {
+            try {
+                function();
+            } catch (...) {
+                ::_exit(1);
+            }
+            ::_exit(0);
+        }
+        m_pids.push_back(pid);
+    }
+
+    /**
+     * @brief Espera todos os processos.
+     *
+     * @return true se todos terminaram com status zero.
+     */
+    bool wait() {
+        bool ok = true;
+        for (pid_t pid : m_pids) {
+            int status;
+            while (::waitpid(pid, &status, 0) < 0) {
+                if (errno != EINTR) {
+                    status = -1;
+                    break;
+                }
+            }
+            ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        m_pids.clear();
+        return ok;
+    }
+};
+
+/**
+ * @brief Sequência ordenada e sem duplicatas de linhas contíguas.
+ */
+template <typename F> struct sorted_run {
+    const F* rows;
+    size_t count;
+};
+
+/**
+ * @brief Intercala sequências ordenadas, removendo duplicatas.
+ *
+ * @param visit Função chamada com cada linha distinta, em ordem.
+ */
+template <typename F, typename Visitor>
+void merge(const std::vector<sorted_run<F>>& runs, size_t width,
+           Visitor visit) {
+    std::vector<size_t> next(runs.size());
+    auto head = [&](size_t r) { return runs[r].rows + next[r] * width; };
+    auto greater = [&](size_t a, size_t b) {
+        return internal_rows::less(head(b), head(a), width);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> queue(
+        greater);
+    for (size_t r = 0; r < runs.size(); r++) {
+        if (runs[r].count > 0) {
+            queue.push(r);
+        }
+    }
+
+    const F* last = nullptr;
+    while (!queue.empty()) {
+        size_t r = queue.top();
+        queue.pop();
+
+        const F* row = head(r);
+        if (last == nullptr || !internal_rows::equal(row, last, width)) {
+            visit(row);
+            last = row;
+        }
+        if (++next[r] < runs[r].count) {
+            queue.push(r);
+        }
+    }
+}
+
+/**
+ * @brief Passo de eliminação de Fourier-Motzkin com os pares N × P
+ * distribuídos entre processos.
+ */
+template <typename F>
+polyhedron<F> eliminate(const polyhedron<F>& P, const vecn<F>& direction,
+                        size_t variable, const sharded_options& options,
+                        budget& resources) {
+    step_timer timer(variable, false);
+    const auto& A = P.A();
+    size_t cols = A.cols(), width = cols + 1;
+
+    // A entrada é copiada para um segmento compartilhado no formato binário,
+    // lido por todos os processos.
+    shared_segment input(binary_size<F>(A.rows(), cols));
+    write_header<F>(input.data(), A.rows(), cols);
+    F* rows = rows_of<F>(input.data());
+    for (size_t i = 0; i < A.rows(); i++) {
+        std::copy(A.row_data(i), A.row_data(i) + cols, rows + i * width);
+        rows[i * width + cols] = P.b().unchecked_at(i);
+    }
+
+    std::vector<F> dots;
+    std::vector<size_t> N, Z, Q;
+    partition(input.data(), direction, dots, N, Z, Q);
+    std::uint64_t pairs = std::uint64_t(N.size()) * Q.size();
+    // O poliedro de entrada, mais as linhas contíguas (sem preenchimento) dos
+    // segmentos de entrada e de saída.
+    resources.check_allocation(
+        Z.size() + pairs,
+        budget::sum(budget::polyhedron_bytes<F>(A.rows(), cols),
+                    budget::bytes(A.rows() + Z.size() + pairs, width,
+                                  sizeof(F))));
+
+    size_t processes = options.processes;
+    if (processes == 0) {
+        processes = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t shards = size_t(std::min<std::uint64_t>(
+        processes, (pairs + MIN_SHARD_PAIRS - 1) / MIN_SHARD_PAIRS));
+
+    // Cada tarefa escreve em um segmento próprio, com espaço para todos os
+    // seus pares.
+    std::vector<shared_segment> outputs;
+    std::vector<shard_task> tasks;
+    for (size_t k = 0; k < shards; k++) {
+        shard_task task = {pairs * k / shards, pairs * (k + 1) / shards};
+        tasks.push_back(task);
+        outputs.emplace_back(binary_size<F>(task.last - task.first, cols));
+    }
+
+    worker_group workers;
+    if (shards == 1) {
+        run_shard(input.data(), direction, tasks[0], outputs[0].data(),
+                  resources);
+    } else {
+        for (size_t k = 0; k < shards; k++) {
+            workers.spawn([&, k]() {
+                try {
+                    run_shard(input.data(), direction, tasks[k],
+                              outputs[k].data(), resources);
+                } catch (budget_exceeded&) {
+                    header_of(outputs[k].data()).reserved = SHARD_TIMEOUT;
+                }
+            });
+        }
+    }
+
+    // Enquanto os processos trabalham, as linhas de Z são normalizadas,
+    // ordenadas e deduplicadas neste processo.
+    std::vector<F> zero;
+    zero.reserve(Z.size() * width);
+    for (size_t z : Z) {
+        zero.insert(zero.end(), rows + z * width, rows + (z + 1) * width);
+        if (!internal_rows::normalize(&zero[zero.size() - width], cols)) {
+            zero.resize(zero.size() - width);
+        }
+    }
+    size_t zero_rows = sort_unique(zero.data(), zero.size() / width, width);
+
+    bool ok = workers.wait();
+    bool timeout = false;
+    for (const auto& output : outputs) {
+        auto status = header_of(output.data()).reserved;
+        timeout = timeout || status == SHARD_TIMEOUT;
+        ok = ok && (status == SHARD_DONE || status == SHARD_TIMEOUT);
+    }
+    if (timeout) {
+        resources.check_time();
+    }
+    if (!ok || timeout) {
+        throw shard_error("worker process failed");
+    }
+
+    std::vector<sorted_run<F>> runs = {{zero.data(), zero_rows}};
+    for (const auto& output : outputs) {
+        runs.push_back({rows_of<F>(static_cast<const void*>(output.data())),
+                        size_t(header_of(output.data()).rows)});
+    }
+
+    size_t count = 0;
+    merge(runs, width, [&](const F*) { count++; });
+
+    matnxm<F> D(count, cols);
+    vecn<F> d(count);
+    size_t i = 0;
+    merge(runs, width, [&](const F* row) {
+        std::copy(row, row + cols, D.row_data(i));
+        d.unchecked_at(i++) = row[cols];
+    });
+
+    timer.finish(N.size(), Z.size(), Q.size(), count,
+                 Z.size() + pairs - count,
+                 budget::polyhedron_bytes<F>(count, cols));
+    return {std::move(D), std::move(d)};
+}
+}; // namespace internal_sharded
+
+/**
+ * @brief Calcula o poliedro de projeção na direção dada (vide
+ * `polyhedron::project`) com os pares N × P distribuídos entre processos.
+ *
+ * O poliedro é copiado para um segmento de memória compartilhada no formato
+ * binário (vide `io/binary.hpp`), e cada processo, criado com `fork`, gera as
+ * linhas de um intervalo de pares em um segmento próprio, já ordenadas e sem
+ * duplicatas. O processo original intercala os resultados. Como na
+ * eliminação em memória externa, as linhas do resultado são normalizadas,
+ * ordenadas e sem duplicatas, e linhas triviais são descartadas. Passos com
+ * poucos pares são feitos no próprio processo.
+ *
+ * @param P Poliedro.
+ * @param direction Vetor que indica a direção da projeção.
+ * @param options Opções da eliminação distribuída.
+ * @param resources Orçamento de recursos.
+ * @return polyhedron<F> O poliedro de projeção.
+ */
+template <typename F>
+polyhedron<F> sharded_project(const polyhedron<F>& P, const vecn<F>& direction,
+                              const sharded_options& options,
+                              budget& resources) {
+    internal::validate("cannot project polyhedron on direction with "
+                       "incompatible dimensions",
+                       [&]() { return P.dimensions() == direction.size(); });
+
+    resources.begin_step(budget::no_variable);
+    return internal_sharded::eliminate(P, direction, budget::no_variable,
+                                       options, resources);
+}
+
+template <typename F>
+polyhedron<F> sharded_project(const polyhedron<F>& P, const vecn<F>& direction,
+                              const sharded_options& options) {
+    budget unlimited;
+    return sharded_project(P, direction, options, unlimited);
+}
+
+/**
+ * @brief Determina se um poliedro é vazio com os passos de eliminação
+ * distribuídos entre processos (vide `sharded_project`).
+ *
+ * As variáveis são eliminadas na ordem que gera menos linhas a cada passo,
+ * sem a propagação de limites de `polyhedron::empty`, e a eliminação termina
+ * assim que uma linha 0 <= b com b < 0 é gerada.
+ *
+ * @param P Poliedro.
+ * @param options Opções da eliminação distribuída.
+ * @param resources Orçamento de recursos.
+ * @return true se o poliedro é vazio.
+ */
+template <typename F>
+bool sharded_empty(const polyhedron<F>& P, const sharded_options& options,
+                   budget& resources) {
+    // Uma linha 0 <= b com b < 0 prova o vazio.
+    auto infeasible = [](const polyhedron<F>& Q) {
+        for (size_t i = 0; i < Q.A().rows(); i++) {
+            const F* a = Q.A().row_data(i);
+            if (Q.b().unchecked_at(i) < 0 &&
+                std::all_of(a, a + Q.A().cols(), [](F x) { return x == 0; })) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    polyhedron<F> current = P;
+    std::vector<char> eliminated(P.dimensions());
+    for (size_t step = 0; step < P.dimensions(); step++) {
+        if (infeasible(current)) {
+            return true;
+        }
+
+        column_index<F> index(current.A());
+        size_t best = P.dimensions();
+        for (size_t j = 0; j < P.dimensions(); j++) {
+            if (!eliminated[j] &&
+                (best == P.dimensions() ||
+                 index.elimination_rows(j) < index.elimination_rows(best))) {
+                best = j;
+            }
+        }
+
+        vecn<F> direction(P.dimensions());
+        direction[best] = 1;
+        eliminated[best] = 1;
+        resources.begin_step(best);
+        current = internal_sharded::eliminate(current, direction, best, options,
+                                              resources);
+    }
+    return infeasible(current);
+}
+
+template <typename F>
+bool sharded_empty(const polyhedron<F>& P, const sharded_options& options) {
+    budget unlimited;
+    return sharded_empty(P, options, unlimited);
+}
+
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_SHARDED__
@@ -0,0 +1,178 @@
+#ifndef __POLYHEDRAL_STATS__
+#define __POLYHEDRAL_STATS__
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace polyhedral {
+
+/**
+ * @brief Estatísticas de um passo de eliminação.
+ */
+struct step_stats {
+    // Variável eliminada, ou `budget::no_variable` para uma projeção em
+    // direção arbitrária.
+    size_t variable;
+
+    // Se verdadeiro, o passo foi feito em memória externa.
+    bool external;
+
+    // Tamanhos da partição das linhas de entrada.
+    size_t negative;
+    size_t zero;
+    size_t positive;
+
+    // Número de linhas do resultado.
+    size_t rows;
+
+    // Número de linhas descartadas (|Z| + |N| × |P| - rows).
+    size_t pruned;
+
+    // Número de bytes do resultado.
+    size_t bytes;
+
+    // Início do passo, relativo à criação do `stats_recorder`, e duração.
+    std::chrono::nanoseconds start;
+    std::chrono::nanoseconds duration;
+};
+
+/**
+ * @brief Registro das estatísticas dos passos de eliminação feitos em uma
+ * thread enquanto um `stats_scope` estiver ativo.
+ */
+class stats_recorder {
+  private:
+    std::chrono::steady_clock::time_point m_origin;
+    std::vector<step_stats> m_steps;
+
+  public:
+    stats_recorder() : stats_recorder(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Constrói um registro cujos tempos são relativos a um instante
+     * dado (e.g. para combinar os registros de várias threads).
+     *
+     * @param origin Instante de referência.
+     */
+    explicit stats_recorder(std::chrono::steady_clock::time_point origin)
+        : m_origin(origin) {}
+
+    /**
+     * @brief Instante de referência dos tempos registrados.
+     */
+    std::chrono::steady_clock::time_point origin() const { return m_origin; }
+
+    /**
+     * @brief Passos registrados, em ordem de término.
+     */
+    const std::vector<step_stats>& steps() const { return m_steps; }
+
+    /**
+     * @brief Registra um passo.
+     */
+    void record(const step_stats& step) { m_steps.push_back(step); }
+
+    /**
+     * @brief Descarta os passos registrados.
+     */
+    void clear() { m_steps.clear(); }
+};
+
+#ifdef NOSTATS
+static constexpr bool stats_enabled = false;
+
+class stats_scope {
+  public:
+    explicit stats_scope(stats_recorder&) {}
+};
+
+class step_timer {
+  public:
+    step_timer(size_t, bool) {}
+
+    void finish(size_t, size_t, size_t, size_t, size_t, size_t) {}
+};
+#else
+static constexpr bool stats_enabled = true;
+
+/**
+ * @brief Registro ativo na thread atual (nulo se nenhum estiver ativo).
+ */
+inline stats_recorder*& current_recorder() {
+    static thread_local stats_recorder* recorder = nullptr;
+    return recorder;
+}
+
+/**
+ * @brief Ativa um registro na thread atual durante a vida do objeto.
+ */
+class stats_scope {
+  private:
+    stats_recorder* m_previous;
+
+  public:
+    explicit stats_scope(stats_recorder& recorder)
+        : m_previous(current_recorder()) {
+        current_recorder() = &recorder;
+    }
+
+    ~stats_scope() { current_recorder() = m_previous; }
+
+    stats_scope(const stats_scope&) = delete;
+    stats_scope& operator=(const stats_scope&) = delete;
+};
+
+/**
+ * @brief Mede um passo de eliminação e o registra no registro ativo, se
+ * houver. Sem registro ativo, o custo é a leitura de um ponteiro.
+ */
+class step_timer {
+  private:
+    stats_recorder* m_recorder;
+    size_t m_variable;
+    bool m_external;
+    std::chrono::steady_clock::time_point m_start;
+
+  public:
+    step_timer(size_t variable, bool external)
+        : m_recorder(current_recorder()), m_variable(variable),
+          m_external(external) {
+        if (m_recorder != nullptr) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    /**
+     * @brief Termina a medição do passo.
+     *
+     * @param negative, zero, positive Tamanhos de N, Z e P.
+     * @param rows Número de linhas do resultado.
+     * @param pruned Número de linhas descartadas.
+     * @param bytes Número de bytes do resultado.
+     */
+    void finish(size_t negative, size_t zero, size_t positive, size_t rows,
+                size_t pruned, size_t bytes) {
+        if (m_recorder == nullptr) {
+            return;
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        step_stats step;
+        step.variable = m_variable;
+        step.external = m_external;
+        step.negative = negative;
+        step.zero = zero;
+        step.positive = positive;
+        step.rows = rows;
+        step.pruned = pruned;
+        step.bytes = bytes;
+        step.start = m_start - m_recorder->origin();
+        step.duration = end - m_start;
+        m_recorder->record(step);
+    }
+};
+#endif
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_STATS__
@@ -0,0 +1,220 @@
+#ifndef __POLYHEDRAL_STREAMING__
+#define __POLYHEDRAL_STREAMING__
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <internal.hpp>
+#include <linalg.hpp>
+
+#include "budget.hpp"
+#include "external.hpp"
+#include "polyhedron.hpp"
+#include "projection.hpp"
+#include "stats.hpp"
+
+namespace polyhedral {
+using namespace linalg;
+
+/**
+ * @brief Opções da projeção em fluxo.
+ */
+struct stream_options {
+    // Número máximo de linhas entregues ao destino de uma vez.
+    size_t chunk = 4096;
+
+    // Número de linhas recentes guardadas para a remoção de duplicatas. Se
+    // zero, as linhas não são comparadas.
+    size_t window = 0;
+};
+
+namespace internal_streaming {
+/**
+ * @brief Janela das últimas linhas emitidas, para a remoção de duplicatas em
+ * memória limitada.
+ *
+ * As linhas são guardadas normalizadas (vide `internal_rows::normalize`) em um
+ * buffer circular, indexado por um hash das linhas. Uma linha repetida só é
+ * detectada se a sua cópia anterior ainda está na janela.
+ *
+ * @tparam F Tipo de escalar.
+ */
+template <typename F> class row_window {
+  private:
+    size_t m_width;
+    size_t m_capacity;
+    size_t m_size = 0;
+    size_t m_next = 0;
+
+    std::vector<F> m_rows;
+    std::vector<size_t> m_hashes;
+    std::vector<F> m_scratch;
+    std::unordered_multimap<size_t, size_t> m_index;
+
+  public:
+    /**
+     * @param cols Número de coeficientes das linhas.
+     * @param capacity Número de linhas guardadas.
+     */
+    row_window(size_t cols, size_t capacity)
+        : m_width(cols + 1), m_capacity(capacity),
+          m_rows(capacity * (cols + 1)), m_hashes(capacity),
+          m_scratch(cols + 1) {
+        m_index.reserve(capacity);
+    }
+
+    /**
+     * @brief Insere uma linha na janela, descartando a mais antiga se a
+     * janela estiver cheia.
+     *
+     * @param row Ponteiro para os `cols + 1` escalares da linha.
+     * @return true se a linha não estava na janela.
+     * @return false se a linha é múltipla positiva de uma linha da janela.
+     */
+    bool insert(const F* row) {
+        if (m_capacity == 0) {
+            return true;
+        }
+
+        F* scratch = m_scratch.data();
+        std::copy_n(row, m_width, scratch);
+        internal_rows::normalize(scratch, m_width - 1);
+
+        size_t hash = 0;
+        for (size_t j = 0; j < m_width; j++) {
+            hash = hash * 1000003 ^ std::hash<F>()(scratch[j]);
+        }
+
+        auto range = m_index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (internal_rows::equal<F>(scratch, slot(it->second), m_width)) {
+                return false;
+            }
+        }
+
+        if (m_size == m_capacity) {
+            evict(m_next);
+        } else {
+            m_size++;
+        }
+        std::copy_n(scratch, m_width, slot(m_next));
+        m_hashes[m_next] = hash;
+        m_index.emplace(hash, m_next);
+        m_next = (m_next + 1) % m_capacity;
+        return true;
+    }
+
+  private:
+    F* slot(size_t k) { return m_rows.data() + k * m_width; }
+
+    /**
+     * @brief Remove do índice a linha guardada em uma posição da janela.
+     */
+    void evict(size_t k) {
+        auto range = m_index.equal_range(m_hashes[k]);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == k) {
+                m_index.erase(it);
+                return;
+            }
+        }
+    }
+};
+}; // namespace internal_streaming
+
+/**
+ * @brief Projeta um poliedro em uma direção por Fourier-Motzkin, entregando as
+ * linhas de P(D, d) ao destino à medida que são calculadas, sem nunca
+ * construir a matriz D.
+ *
+ * As linhas seguem a ordem de `projection::materialize` e são entregues em
+ * blocos de até `options.chunk` linhas; a memória usada é O((m + chunk) n),
+ * independente do número |Z| + |N| × |P| de linhas do resultado. Com
+ * `options.window` não nulo, as linhas repetidas dentro das últimas `window`
+ * linhas emitidas são descartadas.
+ *
+ * @tparam Sink Função chamada com uma matriz cujas linhas são as linhas
+ * aumentadas [D_i | d_i] do bloco (d_i na primeira coluna reservada) e o
+ * número de linhas do bloco.
+ *
+ * @param P Poliedro.
+ * @param direction Direção da projeção.
+ * @param sink Destino das linhas.
+ * @param resources Orçamento de recursos.
+ * @param options Opções da projeção em fluxo.
+ * @return size_t O número de linhas entregues ao destino.
+ */
+template <typename F, typename Sink>
+size_t stream_project(const polyhedron<F>& P, const vecn<F>& direction,
+                      Sink&& sink, budget& resources,
+                      const stream_options& options = {}) {
+    internal::validate("cannot project polyhedron on direction with "
+                       "incompatible dimensions",
+                       [&]() { return P.dimensions() == direction.size(); });
+
+    resources.begin_step(budget::no_variable);
+    step_timer timer(budget::no_variable, false);
+
+    projection<F> step(P, direction);
+    const auto& A = P.A();
+    const auto& dots = step.dots();
+    size_t n = P.dimensions();
+    size_t chunk = std::max<size_t>(1, std::min(options.chunk, step.rows()));
+
+    // O limite de linhas se refere às linhas geradas; o de memória, à entrada,
+    // ao bloco e à janela.
+    resources.check_allocation(
+        step.rows(),
+        budget::sum(budget::sum(budget::polyhedron_bytes<F>(A.rows(), n),
+                                budget::polyhedron_bytes<F>(chunk, n)),
+                    budget::bytes(options.window, n + 1, sizeof(F))));
+
+    matnxm<F> block(chunk, n, 1);
+    internal_streaming::row_window<F> window(n, options.window);
+    size_t count = 0, emitted = 0, removed = 0;
+
+    auto flush = [&]() {
+        if (count > 0) {
+            sink(static_cast<const matnxm<F>&>(block), count);
+            emitted += count;
+            count = 0;
+        }
+    };
+    auto emit = [&]() {
+        if (!window.insert(block.row_data(count))) {
+            removed++;
+        } else if (++count == chunk) {
+            flush();
+        }
+    };
+
+    // Mesma ordem de `projection::materialize`: Z e então N × P.
+    for (size_t z : step.zero()) {
+        std::copy_n(A.row_data(z), n + 1, block.row_data(count));
+        emit();
+    }
+
+    for (size_t s : step.negative()) {
+        resources.check_time();
+        F np = dots.unchecked_at(s);
+        for (size_t t : step.positive()) {
+            internal_projection::combine_rows(A.row_data(s),
+                                              dots.unchecked_at(t),
+                                              A.row_data(t), np, n + 1,
+                                              block.row_data(count));
+            emit();
+        }
+    }
+    flush();
+
+    timer.finish(step.negative().size(), step.zero().size(),
+                 step.positive().size(), emitted, removed,
+                 budget::polyhedron_bytes<F>(chunk, n));
+    return emitted;
+}
+}; // namespace polyhedral
+
+#endif // __POLYHEDRAL_STREAMING__
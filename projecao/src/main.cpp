@@ -1,16 +1,37 @@
 #include "io/parser.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
 
+#include <concurrent/bounded_queue.hpp>
 #include <io.hpp>
+#include <io/cache.hpp>
+#include <io/protocol.hpp>
 #include <iterator>
 #include <linalg.hpp>
 #include <polyhedral.hpp>
+#include <polyhedral/sharded.hpp>
 #include <string>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
 
 using namespace io;
 using namespace linalg;
@@ -19,81 +40,467 @@ using namespace polyhedral;
 // Tipo de escalar.
 using scalar_type = double;
 
-class file_processor {
+// Nomes dos métodos de projeção, na linha de comando e na descrição das
+// opções de algoritmo que afetam os resultados guardados no cache.
+static const struct {
+    const char* option;
+    const char* description;
+    projection_engine engine;
+} ENGINES[] = {
+    {"auto", "auto", projection_engine::AUTO},
+    {"fm", "fourier-motzkin", projection_engine::FOURIER_MOTZKIN},
+    {"dd", "double-description", projection_engine::DOUBLE_DESCRIPTION},
+};
+
+/**
+ * @brief Opções de linha de comando.
+ */
+struct options {
+    // Diretório do cache de resultados (vazio se o cache estiver desabilitado).
+    std::string cache_dir;
+
+    // Tamanho máximo do cache, em bytes.
+    size_t cache_size = size_t(256) << 20;
+
+    // Se verdadeiro, recalcula todo acerto no cache e compara os resultados.
+    bool cache_verify = false;
+
+    // Limites de recursos para o processamento de cada arquivo.
+    resource_limits limits;
+
+    // Se verdadeiro, as eliminações são feitas em memória externa.
+    bool out_of_core = false;
+
+    // Opções da eliminação em memória externa.
+    external_options external;
+
+    // Se verdadeiro, os pares N × P das eliminações são distribuídos entre
+    // processos.
+    bool sharded = false;
+
+    // Opções da eliminação distribuída entre processos.
+    sharded_options sharding;
+
+    // Se verdadeiro, exibe as estatísticas de cada eliminação.
+    bool stats = false;
+
+    // Arquivo de saída do trace de eliminações (vazio se desabilitado).
+    std::string trace_file;
+
+    // Número de threads que resolvem tarefas e leem as desigualdades das
+    // entradas (0 para uma por processador).
+    size_t jobs = 0;
+
+    // Tamanho, em bytes, dos trechos da seção de desigualdades de uma entrada
+    // lidos em paralelo.
+    size_t parse_chunk = size_t(1) << 20;
+
+    // Método das projeções.
+    projection_engine engine = projection_engine::AUTO;
+
+    // Se verdadeiro, os testes de vazio e as projeções em eixos decidem os
+    // sinais exatamente (vide `filtered_eliminate`).
+    bool filtered = false;
+
+    // Se verdadeiro, os testes de vazio filtrados guardam as linhas em
+    // precisão simples (vide `screened_empty`).
+    bool screening = false;
+
+    // Se verdadeiro, as projeções são escritas à medida que as linhas são
+    // geradas, sem construir o resultado (vide `stream_project`).
+    bool stream = false;
+
+    // Opções das projeções em fluxo.
+    stream_options streaming;
+
+    // Se verdadeiro, responde requisições em vez de processar arquivos.
+    bool serve = false;
+
+    // Socket Unix do modo servidor (vazio para usar a entrada e a saída
+    // padrão).
+    std::string socket_path;
+};
+
+// Capacidade das filas entre os estágios do pipeline.
+static constexpr size_t PIPELINE_QUEUE_SIZE = 64;
+
+/**
+ * @brief Número de threads pedido por `--jobs`, ou uma por processador.
+ */
+static size_t job_threads(const options& opts) {
+    if (opts.jobs > 0) {
+        return opts.jobs;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Escapa uma string para JSON.
+ */
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+/**
+ * @brief Instrumentação das operações do programa: registra os passos de
+ * eliminação de cada operação, exibe um resumo e escreve um trace no formato
+ * de eventos do Chrome (chrome://tracing, Perfetto).
+ *
+ * Pode ser usada por várias threads ao mesmo tempo; cada thread aparece no
+ * trace com o seu próprio identificador.
+ */
+class instrumentation {
   private:
-    const char* m_filename;
-    std::ifstream m_stream;
-    size_t m_lineno = 1;
+    /**
+     * @brief Intervalo de uma operação (teste de vazio ou projeção).
+     */
+    struct span {
+        std::string name;
+        size_t thread;
+        std::chrono::nanoseconds start;
+        std::chrono::nanoseconds duration;
+    };
+
+    std::chrono::steady_clock::time_point m_origin;
+    std::mutex m_mutex;
+    std::vector<span> m_spans;
+    std::vector<std::pair<size_t, step_stats>> m_steps;
+    bool m_summary;
 
   public:
-    file_processor(const char* filename) : m_filename(filename) {}
+    explicit instrumentation(bool summary)
+        : m_origin(std::chrono::steady_clock::now()), m_summary(summary) {}
+
+    /**
+     * @brief Executa uma operação, registrando seus passos de eliminação.
+     *
+     * @param name Nome da operação.
+     * @param thread Identificador da thread que executa a operação.
+     * @param summary Stream de saída do resumo da operação.
+     * @param operation Função que executa a operação.
+     * @return O resultado da operação.
+     */
+    template <typename Operation>
+    auto measure(const std::string& name, size_t thread, std::ostream& summary,
+                 Operation&& operation) -> decltype(operation()) {
+        stats_recorder recorder(m_origin);
+        stats_scope scope(recorder);
+        auto start = std::chrono::steady_clock::now();
+
+        // O intervalo é registrado mesmo que a operação seja interrompida.
+        struct guard {
+            instrumentation& self;
+            const std::string& name;
+            size_t thread;
+            std::ostream& summary;
+            const stats_recorder& recorder;
+            std::chrono::steady_clock::time_point start;
+
+            ~guard() {
+                auto end = std::chrono::steady_clock::now();
+                span s{name, thread, start - self.m_origin, end - start};
+                if (self.m_summary) {
+                    self.summarize(s, recorder.steps(), summary);
+                }
+
+                std::lock_guard<std::mutex> lock(self.m_mutex);
+                self.m_spans.push_back(std::move(s));
+                for (const auto& step : recorder.steps()) {
+                    self.m_steps.emplace_back(thread, step);
+                }
+            }
+        } g{*this, name, thread, summary, recorder, start};
 
-    void run() {
-        std::cout << "[" << m_filename << "]" << std::endl;
-        m_stream.open(m_filename);
+        return operation();
+    }
 
-        // Lê um poliedro do arquivo.
-        polyhedron<scalar_type> P = read_polyhedron();
+    /**
+     * @brief Escreve o trace de todas as operações registradas.
+     *
+     * @param os Stream de saída.
+     */
+    void write_trace(std::ostream& os) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto microseconds = [](std::chrono::nanoseconds t) {
+            return std::chrono::duration<double, std::micro>(t).count();
+        };
 
-        std::cout << "(P) " << P.A().rows() << " x " << P.A().cols()
-                  << std::endl
-                  << P << std::endl;
+        os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [" << std::endl;
+        const char* separator = "";
+        for (const auto& s : m_spans) {
+            os << separator << "  {\"name\": " << json_string(s.name)
+               << ", \"cat\": \"operation\", \"ph\": \"X\", \"pid\": 1, "
+                  "\"tid\": "
+               << s.thread << ", \"ts\": " << microseconds(s.start)
+               << ", \"dur\": " << microseconds(s.duration) << "}";
+            separator = ",\n";
+        }
+        for (const auto& entry : m_steps) {
+            const auto& step = entry.second;
+            os << separator << "  {\"name\": " << json_string(step_name(step))
+               << ", \"cat\": \"step\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+               << entry.first << ", \"ts\": " << microseconds(step.start)
+               << ", \"dur\": " << microseconds(step.duration)
+               << ", \"args\": {\"N\": " << step.negative
+               << ", \"Z\": " << step.zero << ", \"P\": " << step.positive
+               << ", \"rows\": " << step.rows << ", \"pruned\": " << step.pruned
+               << ", \"bytes\": " << step.bytes << ", \"external\": "
+               << (step.external ? "true" : "false") << "}}";
+            separator = ",\n";
+        }
+        os << std::endl << "]}" << std::endl;
+    }
+
+  private:
+    static std::string step_name(const step_stats& step) {
+        return step.variable == budget::no_variable
+                   ? "project"
+                   : "eliminate x" + std::to_string(step.variable + 1);
+    }
+
+    /**
+     * @brief Escreve o resumo de uma operação e de seus passos de eliminação.
+     */
+    static void summarize(const span& s, const std::vector<step_stats>& steps,
+                          std::ostream& os) {
+        auto milliseconds = [](std::chrono::nanoseconds t) {
+            return std::chrono::duration<double, std::milli>(t).count();
+        };
 
-        std::cout << "P is" << (P.empty() ? " " : " not ") << "empty"
-                  << std::endl
-                  << std::endl;
+        char line[256];
+        std::snprintf(line, sizeof(line), "stats: %s: %zu steps, %.3f ms",
+                      s.name.c_str(), steps.size(), milliseconds(s.duration));
+        os << line << std::endl;
+        if (steps.empty()) {
+            return;
+        }
 
-        // Faz a projeção do poliedro em cada uma das direções dadas.
-        vecn<scalar_type> c;
-        while (read_vector(c)) {
-            std::cout << "Projected on direction " << c << ":" << std::endl;
-            std::cout << P.project(c) << std::endl;
+        std::snprintf(line, sizeof(line),
+                      "  %4s %-13s %8s %8s %8s %10s %10s %12s %12s", "step",
+                      "variable", "|N|", "|Z|", "|P|", "rows", "pruned",
+                      "bytes", "time (ms)");
+        os << line << std::endl;
+        for (size_t k = 0; k < steps.size(); k++) {
+            const auto& step = steps[k];
+            std::snprintf(line, sizeof(line),
+                          "  %4zu %-13s %8zu %8zu %8zu %10zu %10zu %12zu %12.3f",
+                          k + 1, step_name(step).c_str(), step.negative,
+                          step.zero, step.positive, step.rows, step.pruned,
+                          step.bytes, milliseconds(step.duration));
+            os << line << std::endl;
         }
     }
+};
+
+/**
+ * @brief Arquivo de entrada: dados compartilhados pelas tarefas do arquivo.
+ */
+struct input_file {
+    std::string name;
+    polyhedron<scalar_type> P;
+
+    // Orçamento do arquivo. Cada tarefa usa uma cópia, de forma que os passos
+    // são contados por tarefa e o tempo a partir da leitura do arquivo.
+    budget resources;
+
+    // Cópia em disco do poliedro, criada no primeiro uso.
+    std::once_flag external_once;
+    std::unique_ptr<external_polyhedron<scalar_type>> external;
 
+    input_file(std::string name, const resource_limits& limits)
+        : name(std::move(name)), resources(limits) {}
+};
+
+/**
+ * @brief Saída de uma tarefa, escrita em ordem de `sequence`.
+ */
+struct task_output {
+    size_t sequence = 0;
+    std::string out;
+    std::string err;
+
+    // Se verdadeiro, é a última saída da sua fila.
+    bool last = false;
+
+    // Se verdadeiro, é um trecho da saída da tarefa, seguido de outros trechos
+    // com a mesma posição.
+    bool partial = false;
+};
+
+/**
+ * @brief Tarefa do pipeline: um teste de vazio, uma projeção, ou um texto já
+ * pronto (e.g. um erro de leitura).
+ */
+struct task {
+    enum kind_t { TEXT, EMPTY, PROJECT };
+
+    // Posição da saída da tarefa na sua fila de saída.
+    size_t sequence = 0;
+    bool last = false;
+    concurrent::bounded_queue<task_output>* sink = nullptr;
+
+    kind_t kind = TEXT;
+    std::shared_ptr<input_file> file;
+    vecn<scalar_type> direction;
+
+    // Saída de tarefas do tipo TEXT.
+    std::string out;
+    std::string err;
+};
+
+/**
+ * @brief Leitor de uma entrada (um arquivo ou o corpo de uma requisição): um
+ * poliedro seguido de direções de projeção.
+ */
+class file_reader {
   private:
+    const char* m_filename;
+    std::istream& m_stream;
+    size_t m_lineno = 1;
+    size_t m_threads;
+    size_t m_chunk_bytes;
+
+    /**
+     * @brief Trecho de linhas inteiras da seção de desigualdades e os termos
+     * lidos dele.
+     */
+    struct inequality_chunk {
+        // Linhas do trecho, separadas por '\0', como as lidas uma a uma, o
+        // que impede a leitura de um escalar de avançar para a linha
+        // seguinte. O texto é descartado depois de lido.
+        std::string text;
+
+        // Número da primeira linha do trecho no arquivo.
+        size_t first_line = 0;
+
+        // Índice da primeira desigualdade do trecho na matriz.
+        size_t first_row = 0;
+
+        // Termos das desigualdades, um após o outro; `ends[r]` é o fim dos
+        // termos da desigualdade r.
+        std::vector<parser::linear_term<scalar_type>> terms;
+        std::vector<size_t> ends;
+        std::vector<scalar_type> rhs;
+
+        // Número de colunas necessárias para as desigualdades do trecho.
+        size_t cols = 0;
+
+        // Erro de sintaxe do trecho, se houver.
+        std::exception_ptr error;
+    };
+
+  public:
+    /**
+     * @brief Constrói um leitor.
+     *
+     * @param filename Nome da entrada, usado nas mensagens de erro.
+     * @param stream Stream de entrada.
+     * @param threads Número máximo de threads que leem as desigualdades.
+     * @param chunk_bytes Tamanho dos trechos da seção de desigualdades.
+     */
+    file_reader(const char* filename, std::istream& stream, size_t threads = 1,
+                size_t chunk_bytes = size_t(1) << 20)
+        : m_filename(filename), m_stream(stream),
+          m_threads(std::max<size_t>(1, threads)),
+          m_chunk_bytes(std::max<size_t>(1, chunk_bytes)) {}
+
     /**
      * @brief Lê um poliedro do arquivo até encontrar uma linha em branco.
      *
+     * A seção de desigualdades é dividida, à medida que é lida, em trechos
+     * de linhas inteiras com cerca de `chunk_bytes` bytes. Cada trecho
+     * completo é entregue a uma thread, com no máximo `threads` trechos
+     * sendo lidos ao mesmo tempo, e guarda os seus termos e o seu maior
+     * índice de variável; o número de colunas é o maior entre os trechos, e
+     * os trechos então escrevem as suas linhas da matriz. Assim, o texto da
+     * seção nunca é guardado inteiro.
+     *
      * @return Um poliedro.
      */
     polyhedron<scalar_type> read_polyhedron() {
-        std::vector<parser::linear_inequality<scalar_type>> inequalities;
+        // Os trechos não mudam de endereço enquanto outros são adicionados, e
+        // são destruídos depois das tarefas que os leem.
+        std::deque<inequality_chunk> chunks;
+        std::deque<std::future<void>> parsing;
 
-        // Lê as inequações que definem o poliedro, uma por linha, e computa
-        // o número de colunas da matriz (i.e. o número de variáveis no
-        // sistema).
-        size_t n = 0;
-        for (std::string line; std::getline(m_stream, line); m_lineno++) {
+        auto dispatch = [&](inequality_chunk& chunk) {
+            if (m_threads == 1) {
+                parse(chunk);
+                return;
+            }
+            if (parsing.size() == m_threads) {
+                parsing.front().wait();
+                parsing.pop_front();
+            }
+            parsing.push_back(std::async(std::launch::async,
+                                         [this, &chunk]() { parse(chunk); }));
+        };
+
+        chunks.emplace_back();
+        chunks.back().first_line = m_lineno;
+        for (std::string line; std::getline(m_stream, line);) {
             // Termina a leitura quando encontra uma linha em branco
             if (line.find_first_not_of(' ') == std::string::npos) {
                 break;
             }
+            m_lineno++;
 
-            parser::linear_inequality<scalar_type> inequality;
-            parser::parser<scalar_type>(m_filename, m_lineno, line.begin(),
-                                        line.end())
-                .parse_linear_inequality(line.begin(), line.end(), inequality);
-
-            n = std::max(n, inequality.lhs.max_variable + 1);
-            inequalities.push_back(std::move(inequality));
+            inequality_chunk& chunk = chunks.back();
+            chunk.text += line;
+            chunk.text += '\0';
+            if (chunk.text.size() >= m_chunk_bytes) {
+                dispatch(chunk);
+                chunks.emplace_back();
+                chunks.back().first_line = m_lineno;
+            }
+        }
+        if (chunks.back().text.empty()) {
+            chunks.pop_back();
+        } else {
+            dispatch(chunks.back());
+        }
+        for (auto& task : parsing) {
+            task.wait();
         }
 
-        // Constrói a matriz A e vetor b correspondentes às inequações
-        // lidas.
-        auto m = inequalities.size();
-        matnxm<scalar_type> A(m, n);
-        vecn<scalar_type> b(m);
-
-        for (size_t i = 0; i < m; i++) {
-            const auto& inequality = inequalities[i];
-            for (const auto& m : inequality.lhs.parts) {
-                A(i, m.variable) += m.coefficient;
+        // O primeiro erro de sintaxe da seção é o do primeiro trecho com erro.
+        size_t m = 0, n = 0;
+        for (auto& chunk : chunks) {
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
             }
-            b[i] = inequality.rhs;
+            chunk.first_row = m;
+            m += chunk.rhs.size();
+            n = std::max(n, chunk.cols);
         }
 
-        return {std::move(A), std::move(b)};
+        // Constrói as linhas aumentadas [A | b] correspondentes às
+        // inequações lidas.
+        matnxm<scalar_type> A(m, n, 1);
+        for_each_chunk(chunks, m_threads, [&](const inequality_chunk& chunk) {
+            for (size_t r = 0, k = 0; r < chunk.rhs.size(); r++) {
+                scalar_type* row = A.row_data(chunk.first_row + r);
+                for (; k < chunk.ends[r]; k++) {
+                    row[chunk.terms[k].variable] += chunk.terms[k].coefficient;
+                }
+                row[n] = chunk.rhs[r];
+            }
+        });
+
+        return polyhedron<scalar_type>::augmented(std::move(A));
     }
 
     /**
@@ -123,23 +530,839 @@ class file_processor {
         }
         return true;
     }
+
+  private:
+    /**
+     * @brief Lê as desigualdades de um trecho, guardando o primeiro erro de
+     * sintaxe em vez de propagá-lo.
+     */
+    void parse(inequality_chunk& chunk) const {
+        parser::linear_inequality<scalar_type> inequality;
+        size_t line = chunk.first_line;
+        try {
+            const std::string& text = chunk.text;
+            for (auto it = text.cbegin(); it != text.cend(); line++) {
+                auto eol = std::find(it, text.cend(), '\0');
+                parser::parser<scalar_type>(m_filename, line, it, eol)
+                    .parse_linear_inequality(it, eol, inequality);
+
+                const auto& lhs = inequality.lhs;
+                chunk.cols = std::max(chunk.cols, lhs.max_variable + 1);
+                chunk.terms.insert(chunk.terms.end(), lhs.parts.begin(),
+                                   lhs.parts.end());
+                chunk.ends.push_back(chunk.terms.size());
+                chunk.rhs.push_back(inequality.rhs);
+                it = eol + 1;
+            }
+        } catch (...) {
+            chunk.error = std::current_exception();
+        }
+        std::string().swap(chunk.text);
+    }
+
+    /**
+     * @brief Aplica uma função a cada trecho, dividindo os trechos em
+     * intervalos consecutivos, um por thread; o primeiro intervalo é
+     * processado na thread atual.
+     */
+    template <typename Chunk, typename Function>
+    static void for_each_chunk(std::deque<Chunk>& chunks, size_t threads,
+                               Function&& f) {
+        threads = std::min(threads, chunks.size());
+        auto range = [&](size_t w) {
+            size_t begin = chunks.size() * w / threads,
+                   end = chunks.size() * (w + 1) / threads;
+            for (size_t k = begin; k < end; k++) {
+                f(chunks[k]);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t w = 1; w < threads; w++) {
+            workers.emplace_back(range, w);
+        }
+        if (threads > 0) {
+            range(0);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
 };
 
-int main(int argc, char** argv) {
-    if (argc <= 1) {
-        std::cout << "Usage: " << argv[0] << " files..." << std::endl;
-        return 1;
+/**
+ * @brief Segundo estágio do pipeline: executa tarefas, formatando as suas
+ * saídas.
+ */
+class solver {
+  private:
+    const options& m_options;
+    result_cache<scalar_type>* m_cache;
+    instrumentation* m_instrumentation;
+    size_t m_thread;
+
+  public:
+    solver(const options& opts, result_cache<scalar_type>* cache,
+           instrumentation* instrumentation, size_t thread)
+        : m_options(opts), m_cache(cache), m_instrumentation(instrumentation),
+          m_thread(thread) {}
+
+    /**
+     * @brief Executa uma tarefa.
+     *
+     * @param t Tarefa.
+     * @return task_output A saída da tarefa.
+     */
+    task_output run(task& t) {
+        std::ostringstream out, err;
+        try {
+            switch (t.kind) {
+            case task::TEXT:
+                out << t.out;
+                err << t.err;
+                break;
+            case task::EMPTY:
+                run_empty(*t.file, out, err);
+                break;
+            case task::PROJECT:
+                if (m_options.stream && !m_options.out_of_core) {
+                    run_stream(t, out, err);
+                } else {
+                    run_project(*t.file, t.direction, out, err);
+                }
+                break;
+            }
+        } catch (std::exception& ex) {
+            err << ex.what() << std::endl;
+        }
+        return {t.sequence, out.str(), err.str(), t.last};
+    }
+
+  private:
+    void run_empty(input_file& file, std::ostream& out, std::ostream& err) {
+        const auto& P = file.P;
+        out << "[" << file.name << "]" << std::endl;
+        out << "(P) " << P.A().rows() << " x " << P.A().cols() << std::endl
+            << P << std::endl;
+
+        budget resources = file.resources;
+        try {
+            bool is_empty = measure("empty " + file.name, err, [&]() {
+                return empty(file, resources);
+            });
+            out << "P is" << (is_empty ? " " : " not ") << "empty"
+                << std::endl;
+        } catch (budget_exceeded& ex) {
+            out << "P emptiness unknown: " << ex.what() << std::endl;
+        }
+        out << std::endl;
+    }
+
+    void run_project(input_file& file, const vecn<scalar_type>& c,
+                     std::ostream& out, std::ostream& err) {
+        out << "Projected on direction " << c << ":" << std::endl;
+
+        std::ostringstream name;
+        name << "project " << file.name << " " << c;
+
+        budget resources = file.resources;
+        try {
+            if (m_options.out_of_core) {
+                out << measure(name.str(), err,
+                               [&]() {
+                                   return external(file).project(c,
+                                                                 resources);
+                               })
+                    << std::endl;
+            } else {
+                out << measure(name.str(), err,
+                               [&]() { return project(file, c, resources); })
+                    << std::endl;
+            }
+        } catch (budget_exceeded& ex) {
+            out << ex.what() << std::endl << std::endl;
+        }
+    }
+
+    /**
+     * @brief Projeta o poliedro de uma tarefa em fluxo, entregando a saída à
+     * fila da tarefa em trechos, um por bloco de linhas. O cache e o método
+     * das projeções não são usados: as linhas vêm de Fourier-Motzkin.
+     */
+    void run_stream(task& t, std::ostringstream& out, std::ostream& err) {
+        input_file& file = *t.file;
+        out << "Projected on direction " << t.direction << ":" << std::endl;
+
+        std::ostringstream name;
+        name << "project " << file.name << " " << t.direction;
+
+        budget resources = file.resources;
+        size_t n = file.P.dimensions();
+        try {
+            size_t rows = measure(name.str(), err, [&]() {
+                return stream_project(
+                    file.P, t.direction,
+                    [&](const matnxm<scalar_type>& block, size_t count) {
+                        for (size_t i = 0; i < count; i++) {
+                            const scalar_type* row = block.row_data(i);
+                            io::write_inequality(out, row, n, row[n]);
+                        }
+                        task_output chunk;
+                        chunk.sequence = t.sequence;
+                        chunk.out = out.str();
+                        chunk.partial = true;
+                        t.sink->push(std::move(chunk));
+                        out.str("");
+                    },
+                    resources, m_options.streaming);
+            });
+            if (rows == 0 || n == 0) {
+                out << "0 <= 0" << std::endl;
+            }
+            out << std::endl;
+        } catch (budget_exceeded& ex) {
+            out << ex.what() << std::endl << std::endl;
+        }
+    }
+
+    /**
+     * @brief Executa uma operação, registrando suas estatísticas caso a
+     * instrumentação esteja habilitada.
+     */
+    template <typename Operation>
+    auto measure(const std::string& name, std::ostream& summary,
+                 Operation&& operation) -> decltype(operation()) {
+        if (m_instrumentation == nullptr) {
+            return operation();
+        }
+        return m_instrumentation->measure(name, m_thread, summary,
+                                          std::forward<Operation>(operation));
+    }
+
+    /**
+     * @brief Determina se o poliedro de um arquivo é vazio, consultando o
+     * cache caso esteja habilitado.
+     */
+    bool empty(input_file& file, budget& resources) {
+        auto compute = [&]() {
+            if (m_options.out_of_core) {
+                return external(file).empty(resources);
+            }
+            if (m_options.screening) {
+                return screened_empty(file.P, resources);
+            }
+            if (m_options.filtered) {
+                return filtered_empty(file.P, resources);
+            }
+            return m_options.sharded
+                       ? sharded_empty(file.P, m_options.sharding, resources)
+                       : file.P.empty(resources);
+        };
+        if (m_cache == nullptr) {
+            return compute();
+        }
+        return m_cache->empty(file.P, compute);
+    }
+
+    /**
+     * @brief Projeta o poliedro de um arquivo em uma direção, consultando o
+     * cache caso esteja habilitado.
+     */
+    polyhedron<scalar_type> project(input_file& file,
+                                    const vecn<scalar_type>& c,
+                                    budget& resources) {
+        auto compute = [&]() {
+            size_t j = internal_projection::axis(c);
+            if (m_options.filtered && j != internal_projection::no_axis) {
+                return filtered_eliminate(file.P, {j}, resources)
+                    .expand(file.P.dimensions());
+            }
+            if (m_options.sharded) {
+                return sharded_project(file.P, c, m_options.sharding,
+                                       resources);
+            }
+            return file.P.project(c, resources, m_options.engine);
+        };
+        if (m_cache == nullptr) {
+            return compute();
+        }
+        return m_cache->project(file.P, c, compute);
+    }
+
+    /**
+     * @brief Cópia em disco do poliedro de um arquivo, criada no primeiro uso.
+     */
+    const external_polyhedron<scalar_type>& external(input_file& file) {
+        std::call_once(file.external_once, [&]() {
+            file.external = std::make_unique<external_polyhedron<scalar_type>>(
+                file.P, m_options.external);
+        });
+        return *file.external;
+    }
+};
+
+/**
+ * @brief Conjunto de threads que executam tarefas, cada uma com um `solver`.
+ * As threads são mantidas entre as entradas (e, no modo servidor, entre as
+ * requisições); cada tarefa é entregue na fila de saída indicada por ela.
+ */
+class worker_pool {
+  private:
+    concurrent::bounded_queue<task> m_tasks;
+    std::vector<std::thread> m_workers;
+
+  public:
+    /**
+     * @brief Inicia as threads.
+     *
+     * @param opts Opções de linha de comando.
+     * @param cache Cache de resultados (nulo se desabilitado).
+     * @param instr Instrumentação (nula se desabilitada).
+     * @param workers Número de threads.
+     */
+    worker_pool(const options& opts, result_cache<scalar_type>* cache,
+                instrumentation* instr, size_t workers)
+        : m_tasks(PIPELINE_QUEUE_SIZE) {
+        for (size_t w = 0; w < workers; w++) {
+            m_workers.emplace_back([&, cache, instr, w]() {
+                solver s(opts, cache, instr, w + 1);
+                for (task t; m_tasks.pop(t);) {
+                    t.sink->push(s.run(t));
+                }
+            });
+        }
     }
 
-    // Processa os arquivos em sequência.
-    std::for_each(argv + 1, argv + argc, [](const char* filename) {
-        file_processor processor(filename);
+    ~worker_pool() {
+        m_tasks.close();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    /**
+     * @brief Envia uma tarefa para execução.
+     */
+    void submit(task t) { m_tasks.push(std::move(t)); }
+};
+
+/**
+ * @brief Primeiro estágio do pipeline: lê entradas em sequência e gera uma
+ * tarefa de teste de vazio por poliedro e uma tarefa de projeção por direção,
+ * à medida que são lidas.
+ */
+class task_source {
+  private:
+    const options& m_options;
+    worker_pool& m_pool;
+    concurrent::bounded_queue<task_output>& m_sink;
+    size_t m_sequence = 0;
+
+  public:
+    /**
+     * @brief Constrói um gerador de tarefas.
+     *
+     * @param opts Opções de linha de comando.
+     * @param pool Threads que executam as tarefas.
+     * @param sink Fila de saída das tarefas.
+     */
+    task_source(const options& opts, worker_pool& pool,
+                concurrent::bounded_queue<task_output>& sink)
+        : m_options(opts), m_pool(pool), m_sink(sink) {}
+
+    /**
+     * @brief Lê uma entrada e gera as suas tarefas.
+     *
+     * @param name Nome da entrada.
+     * @param stream Stream de entrada.
+     * @param op Operações pedidas.
+     */
+    void read(const std::string& name, std::istream& stream,
+              protocol::operation op) {
+        auto file = std::make_shared<input_file>(name, m_options.limits);
+        file_reader reader(file->name.c_str(), stream, job_threads(m_options),
+                           m_options.parse_chunk);
+
+        bool started = false;
         try {
-            processor.run();
+            file->P = reader.read_polyhedron();
+            started = true;
+            if (op != protocol::operation::PROJECT) {
+                task t;
+                t.kind = task::EMPTY;
+                t.file = file;
+                submit(std::move(t));
+            }
+            if (op == protocol::operation::EMPTY) {
+                return;
+            }
+
+            for (vecn<scalar_type> c; reader.read_vector(c);) {
+                task t;
+                t.kind = task::PROJECT;
+                t.file = file;
+                t.direction = std::move(c);
+                submit(std::move(t));
+            }
         } catch (std::exception& ex) {
-            std::cerr << ex.what() << std::endl;
+            // Um erro de leitura termina a entrada, depois das saídas das
+            // tarefas já geradas.
+            task error;
+            if (!started && op != protocol::operation::PROJECT) {
+                error.out = "[" + file->name + "]\n";
+            }
+            error.err = std::string(ex.what()) + "\n";
+            submit(std::move(error));
         }
+    }
+
+    /**
+     * @brief Gera a última tarefa, que marca o fim da fila de saída.
+     */
+    void finish() {
+        task end;
+        end.last = true;
+        submit(std::move(end));
+    }
+
+  private:
+    void submit(task t) {
+        t.sequence = m_sequence++;
+        t.sink = &m_sink;
+        m_pool.submit(std::move(t));
+    }
+};
+
+/**
+ * @brief Último estágio do pipeline: consome uma fila de saída até a última
+ * saída, passando as saídas em ordem para `write` e guardando as que chegam
+ * adiantadas.
+ */
+template <typename Write>
+static void write_ordered(concurrent::bounded_queue<task_output>& outputs,
+                          Write&& write) {
+    std::map<size_t, task_output> pending;
+    size_t next = 0;
+    for (bool done = false; !done;) {
+        task_output o;
+        outputs.pop(o);
+
+        // Os trechos de uma saída são acumulados até a sua vez; a partir
+        // dela, são escritos assim que chegam.
+        task_output& entry = pending[o.sequence];
+        entry.sequence = o.sequence;
+        entry.out += o.out;
+        entry.err += o.err;
+        entry.last = o.last;
+        entry.partial = o.partial;
+
+        for (auto it = pending.begin();
+             it != pending.end() && it->first == next;) {
+            write(it->second);
+            if (it->second.partial) {
+                it->second.out.clear();
+                it->second.err.clear();
+                break;
+            }
+            done = it->second.last;
+            it = pending.erase(it);
+            next++;
+        }
+    }
+}
+
+/**
+ * @brief Processa os arquivos em um pipeline de três estágios: uma thread lê
+ * os arquivos e gera tarefas, as threads de `pool` executam as tarefas, e a
+ * thread atual escreve as saídas na ordem das tarefas.
+ *
+ * Assim, a leitura do próximo arquivo e a escrita dos resultados anteriores
+ * acontecem enquanto o arquivo atual é resolvido, e as projeções começam a
+ * ser calculadas enquanto as direções seguintes ainda são lidas.
+ */
+static void run_files(const std::vector<const char*>& files,
+                      const options& opts, worker_pool& pool) {
+    concurrent::bounded_queue<task_output> outputs(PIPELINE_QUEUE_SIZE);
+
+    std::thread reader([&]() {
+        task_source source(opts, pool, outputs);
+        for (const char* filename : files) {
+            std::ifstream stream(filename);
+            source.read(filename, stream, protocol::operation::RUN);
+        }
+        source.finish();
     });
 
+    write_ordered(outputs, [](const task_output& o) {
+        std::cout << o.out << std::flush;
+        std::cerr << o.err << std::flush;
+    });
+    reader.join();
+}
+
+/**
+ * @brief Responde a uma requisição, com o mesmo pipeline do processamento de
+ * arquivos.
+ */
+static protocol::response serve_request(const protocol::request& req,
+                                        const options& opts,
+                                        worker_pool& pool) {
+    concurrent::bounded_queue<task_output> outputs(PIPELINE_QUEUE_SIZE);
+
+    std::thread reader([&]() {
+        std::istringstream stream(req.body);
+        task_source source(opts, pool, outputs);
+        source.read(req.name, stream, req.op);
+        source.finish();
+    });
+
+    protocol::response res;
+    write_ordered(outputs, [&](const task_output& o) {
+        res.out += o.out;
+        res.err += o.err;
+    });
+    reader.join();
+    return res;
+}
+
+/**
+ * @brief Responde às requisições de uma conexão até o fim da entrada ou um
+ * erro de protocolo.
+ *
+ * @param input Descritor de leitura.
+ * @param output Descritor de escrita.
+ */
+static void serve_connection(int input, int output, const options& opts,
+                             worker_pool& pool) {
+    protocol::channel ch(input, output);
+    try {
+        for (protocol::request req; protocol::read_request(ch, req);) {
+            protocol::write_response(ch, serve_request(req, opts, pool));
+        }
+    } catch (protocol::protocol_error& ex) {
+        try {
+            protocol::write_error(ch, ex.what());
+        } catch (protocol::protocol_error&) {
+            // A conexão já foi fechada pelo cliente.
+        }
+    }
+}
+
+static volatile std::sig_atomic_t g_stop_requested = 0;
+
+static void request_stop(int) { g_stop_requested = 1; }
+
+/**
+ * @brief Aceita conexões em um socket Unix até receber SIGINT ou SIGTERM,
+ * respondendo cada conexão em uma thread.
+ *
+ * @param path Caminho do socket.
+ */
+static void serve_socket(const std::string& path, const options& opts,
+                         worker_pool& pool) {
+    int listener = protocol::listen_unix(path);
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    // Conexões abertas, para que possam ser interrompidas no fim.
+    std::mutex mutex;
+    std::condition_variable closed;
+    std::set<int> connections;
+
+    while (!g_stop_requested) {
+        pollfd p{listener, POLLIN, 0};
+        if (::poll(&p, 1, 200) <= 0) {
+            continue;
+        }
+
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        connections.insert(fd);
+        std::thread([&, fd]() {
+            serve_connection(fd, fd, opts, pool);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            connections.erase(fd);
+            ::close(fd);
+            closed.notify_all();
+        }).detach();
+    }
+
+    ::close(listener);
+    ::unlink(path.c_str());
+
+    // Interrompe a leitura das conexões abertas; as requisições em andamento
+    // são terminadas.
+    std::unique_lock<std::mutex> lock(mutex);
+    for (int fd : connections) {
+        ::shutdown(fd, SHUT_RD);
+    }
+    closed.wait(lock, [&]() { return connections.empty(); });
+}
+
+/**
+ * @brief Descrição de um método de projeção na chave do cache.
+ */
+static const char* engine_description(projection_engine engine) {
+    for (const auto& e : ENGINES) {
+        if (e.engine == engine) {
+            return e.description;
+        }
+    }
+    return "";
+}
+
+/**
+ * @brief Exibe as instruções de uso do programa.
+ */
+static void usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] files..." << std::endl
+              << "       " << program << " [options] --serve[=SOCKET]"
+              << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --cache-dir=DIR   cache results in DIR (default: "
+                 "$COMBPOL_CACHE_DIR)"
+              << std::endl
+              << "  --cache-size=N    evict least recently used results "
+                 "beyond N bytes"
+              << std::endl
+              << "  --cache-verify    recompute cached results and replace "
+                 "mismatches"
+              << std::endl
+              << "  --no-cache        disable the result cache" << std::endl
+              << "  --max-rows=N      abort eliminations generating more "
+                 "than N rows"
+              << std::endl
+              << "  --max-step-bytes=N" << std::endl
+              << "                    abort elimination steps whose input and "
+                 "output rows take"
+              << std::endl
+              << "                    more than N bytes" << std::endl
+              << "  --timeout=S       abort files taking more than S seconds"
+              << std::endl
+              << "  --out-of-core[=N] eliminate on disk, using at most N bytes "
+                 "of row buffers"
+              << std::endl
+              << "  --spill-dir=DIR   write out-of-core temporary files to DIR "
+                 "(default: $TMPDIR)"
+              << std::endl
+              << "  --processes[=N]   split eliminations among N processes "
+                 "over shared memory"
+              << std::endl
+              << "                    (default: one per processor)" << std::endl
+              << "  --stats           print statistics of each elimination "
+                 "step to stderr"
+              << std::endl
+              << "  --trace=FILE      write elimination steps to FILE as Chrome "
+                 "trace events"
+              << std::endl
+              << "  --jobs=N          solve and parse with N threads "
+                 "(default: one per processor)"
+              << std::endl
+              << "  --parse-chunk=N   parse inequalities in chunks of N bytes "
+                 "(default: 1 MiB)"
+              << std::endl
+              << "  --engine=E        project with E: auto (default), fm "
+                 "(Fourier-Motzkin) or dd"
+              << std::endl
+              << "                    (double description)" << std::endl
+              << "  --filtered[=float]" << std::endl
+              << "                    decide signs exactly in emptiness tests "
+                 "and axis projections"
+              << std::endl
+              << "                    (float: store emptiness test rows in "
+                 "single precision)"
+              << std::endl
+              << "  --stream[=N]      print projections while generating "
+                 "rows, N rows at a time"
+              << std::endl
+              << "                    (Fourier-Motzkin, uncached, one thread; "
+                 "default: 4096)"
+              << std::endl
+              << "  --stream-window=W drop streamed rows repeated within the "
+                 "last W rows"
+              << std::endl
+              << "  --serve[=SOCKET]  answer requests on stdin/stdout or on "
+                 "a Unix socket"
+              << std::endl;
+}
+
+/**
+ * @brief Lê um tamanho (inteiro não-negativo) de uma opção de linha de
+ * comando.
+ */
+static bool parse_size(const std::string& value, size_t& output) {
+    char* end;
+    output = std::strtoull(value.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+/**
+ * @brief Lê uma opção de linha de comando.
+ *
+ * @param arg Argumento, no formato `--nome` ou `--nome=valor`.
+ * @param opts Opções de saída.
+ * @return true se a opção for válida.
+ * @return false caso contrário.
+ */
+static bool parse_option(const std::string& arg, options& opts) {
+    auto eq = arg.find('=');
+    std::string name = arg.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+    if (name == "--cache-dir" && !value.empty()) {
+        opts.cache_dir = value;
+    } else if (name == "--cache-size" && !value.empty()) {
+        return parse_size(value, opts.cache_size);
+    } else if (name == "--max-rows" && !value.empty()) {
+        return parse_size(value, opts.limits.max_rows);
+    } else if (name == "--max-step-bytes" && !value.empty()) {
+        return parse_size(value, opts.limits.max_step_bytes);
+    } else if (name == "--out-of-core") {
+        opts.out_of_core = true;
+        return value.empty() || parse_size(value, opts.external.memory);
+    } else if (name == "--spill-dir" && !value.empty()) {
+        opts.external.directory = value;
+    } else if (name == "--processes") {
+        opts.sharded = true;
+        return value.empty() ||
+               (parse_size(value, opts.sharding.processes) &&
+                opts.sharding.processes > 0);
+    } else if (name == "--timeout" && !value.empty()) {
+        char* end;
+        double seconds = std::strtod(value.c_str(), &end);
+        opts.limits.timeout =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(seconds));
+        return *end == '\0' && seconds >= 0;
+    } else if (name == "--jobs" && !value.empty()) {
+        return parse_size(value, opts.jobs) && opts.jobs > 0;
+    } else if (name == "--parse-chunk" && !value.empty()) {
+        return parse_size(value, opts.parse_chunk) && opts.parse_chunk > 0;
+    } else if (name == "--engine") {
+        for (const auto& e : ENGINES) {
+            if (value == e.option) {
+                opts.engine = e.engine;
+                return true;
+            }
+        }
+        return false;
+    } else if (name == "--serve") {
+        opts.serve = true;
+        opts.socket_path = value;
+    } else if (name == "--trace" && !value.empty()) {
+        opts.trace_file = value;
+    } else if (name == "--filtered" &&
+               (eq == std::string::npos || value == "float")) {
+        opts.filtered = true;
+        opts.screening = value == "float";
+    } else if (name == "--stream") {
+        opts.stream = true;
+        return value.empty() || (parse_size(value, opts.streaming.chunk) &&
+                                 opts.streaming.chunk > 0);
+    } else if (name == "--stream-window" && !value.empty()) {
+        return parse_size(value, opts.streaming.window);
+    } else if (name == "--stats" && eq == std::string::npos) {
+        opts.stats = true;
+    } else if (name == "--cache-verify" && eq == std::string::npos) {
+        opts.cache_verify = true;
+    } else if (name == "--no-cache" && eq == std::string::npos) {
+        opts.cache_dir.clear();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    if (const char* cache_dir = std::getenv("COMBPOL_CACHE_DIR")) {
+        opts.cache_dir = cache_dir;
+    }
+
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            files.push_back(argv[i]);
+        } else if (!parse_option(arg, opts)) {
+            std::cerr << "invalid option: " << arg << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (files.empty() != opts.serve) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::unique_ptr<result_cache<scalar_type>> cache;
+    if (!opts.cache_dir.empty()) {
+        cache = std::make_unique<result_cache<scalar_type>>(
+            opts.cache_dir, opts.cache_size, opts.cache_verify,
+            std::string(engine_description(opts.engine)) +
+                (opts.filtered ? "+filtered" : "") +
+                (opts.screening ? "+float" : "") +
+                (opts.out_of_core ? "+out-of-core" : "") +
+                (opts.sharded ? "+sharded" : ""));
+    }
+
+    std::unique_ptr<instrumentation> instr;
+    if (opts.stats || !opts.trace_file.empty()) {
+        if (!stats_enabled) {
+            std::cerr << "warning: statistics disabled at compile time "
+                         "(NOSTATS)"
+                      << std::endl;
+        }
+        instr = std::make_unique<instrumentation>(opts.stats);
+    }
+
+    // Em memória externa, a memória de cada eliminação já é o limite dado, e
+    // as tarefas de um arquivo compartilham os arquivos temporários; com
+    // processos de trabalho, cada eliminação já usa todos os processadores.
+    // Em fluxo, uma tarefa que não é a próxima saída teria os seus blocos
+    // guardados em memória até a sua vez. Nesses casos, as tarefas são
+    // resolvidas uma de cada vez.
+    size_t workers = job_threads(opts);
+    if (opts.out_of_core || opts.sharded || opts.stream) {
+        workers = 1;
+    }
+
+    try {
+        worker_pool pool(opts, cache.get(), instr.get(), workers);
+        if (!opts.serve) {
+            run_files(files, opts, pool);
+        } else {
+            // Um cliente que fecha a conexão não deve terminar o servidor.
+            std::signal(SIGPIPE, SIG_IGN);
+            if (opts.socket_path.empty()) {
+                serve_connection(STDIN_FILENO, STDOUT_FILENO, opts, pool);
+            } else {
+                serve_socket(opts.socket_path, opts, pool);
+            }
+        }
+    } catch (protocol::protocol_error& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (!opts.trace_file.empty()) {
+        std::ofstream trace(opts.trace_file);
+        instr->write_trace(trace);
+        if (!trace) {
+            std::cerr << "cannot write " << opts.trace_file << std::endl;
+            return 1;
+        }
+    }
+
     return 0;
 }